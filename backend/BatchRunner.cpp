@@ -0,0 +1,159 @@
+#include <backend/BatchRunner.h>
+
+#include <algorithm>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+void pinToCore([[maybe_unused]] std::jthread &thread, [[maybe_unused]] const std::size_t core) noexcept {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core, &set);
+  pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set); // best effort, the pool works unpinned too
+#endif
+}
+
+}
+
+BatchRunner::BatchRunner(std::size_t threads, const bool pin) {
+  threads = std::max<std::size_t>(threads, 1);
+  const std::size_t cores = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+  for(std::size_t i = 0; i != threads; ++i)
+    m_queues.push_back(std::make_unique<queue>());
+
+  for(std::size_t i = 0; i != threads; ++i) {
+    m_workers.emplace_back([this, i] { work(i); });
+    if(pin) pinToCore(m_workers.back(), i % cores);
+  }
+}
+
+BatchRunner::~BatchRunner() {
+  {
+    const std::lock_guard guard{m_lock};
+    m_quit = true;
+  }
+  m_start.notify_all();
+  m_workers.clear(); // joins them while the lock they wait on is still around
+}
+
+std::optional<std::size_t> BatchRunner::add(const std::string &rom) {
+  auto emu = std::make_unique<Emu>();
+  if(!emu->plug(rom)) return std::nullopt;
+  emu->skipBoot();
+
+  m_instances.push_back({std::move(emu), {}, {}});
+  return m_instances.size() - 1;
+}
+
+Emu &BatchRunner::operator[](const std::size_t id) noexcept {
+  return *m_instances[id].emu;
+}
+
+std::size_t BatchRunner::size() const noexcept {
+  return m_instances.size();
+}
+
+std::size_t BatchRunner::threads() const noexcept {
+  return m_workers.size();
+}
+
+void BatchRunner::feed(const std::size_t id, std::vector<input> inputs) {
+  m_instances[id].inputs = std::move(inputs);
+}
+
+void BatchRunner::onComplete(const std::size_t id, callback f) {
+  m_instances[id].done = std::move(f);
+}
+
+void BatchRunner::tick(const budget b) {
+  if(m_instances.empty()) return;
+
+  std::unique_lock guard{m_lock};
+  m_budget = b;
+  m_remaining = m_instances.size();
+
+  // Neighbouring machines go to the same worker, the queues are filled under the lock so a worker that's late from the
+  // previous tick can't report machines of this one before they are counted.
+  const std::size_t workers = m_queues.size();
+  for(std::size_t id = 0; id != m_instances.size(); ++id) {
+    queue &q = *m_queues[id * workers / m_instances.size()];
+    const std::lock_guard queue_guard{q.lock};
+    q.ids.push_back(id);
+  }
+
+  ++m_generation;
+  m_start.notify_all();
+  m_finish.wait(guard, [this] { return m_remaining == 0; });
+}
+
+void BatchRunner::work(const std::size_t self) {
+  std::uint64_t seen = 0;
+
+  for(;;) {
+    {
+      std::unique_lock guard{m_lock};
+      m_start.wait(guard, [&] { return m_quit || m_generation != seen; });
+      if(m_quit) return;
+      seen = m_generation;
+    }
+
+    std::size_t done = 0;
+    while(const std::optional<std::size_t> id = take(self)) {
+      run(*id);
+      ++done;
+    }
+
+    const std::lock_guard guard{m_lock};
+    m_remaining -= done;
+    if(m_remaining == 0) m_finish.notify_one();
+  }
+}
+
+// Own queue first, from the front. Then steal from the back of the others, which is away from where their owners are.
+std::optional<std::size_t> BatchRunner::take(const std::size_t self) {
+  const std::size_t workers = m_queues.size();
+
+  for(std::size_t i = 0; i != workers; ++i) {
+    queue &q = *m_queues[(self + i) % workers];
+    const std::lock_guard guard{q.lock};
+    if(q.ids.empty()) continue;
+
+    std::size_t id;
+    if(i == 0) {
+      id = q.ids.front();
+      q.ids.pop_front();
+    } else {
+      id = q.ids.back();
+      q.ids.pop_back();
+    }
+    return id;
+  }
+
+  return std::nullopt;
+}
+
+void BatchRunner::run(const std::size_t id) {
+  instance &i = m_instances[id];
+  Emu &emu = *i.emu;
+
+  for(const input &in : i.inputs)
+    emu.joypad.update(in.btn, in.status);
+  i.inputs.clear();
+
+  switch(m_budget.in) {
+  case budget::frames:
+    for(std::uint64_t frame = 0; frame != m_budget.amount; ++frame)
+      emu.update();
+    break;
+  case budget::cycles: emu.run(m_budget.amount); break;
+  }
+
+  if(i.done) i.done(id, emu);
+}
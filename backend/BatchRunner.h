@@ -0,0 +1,88 @@
+#pragma once
+
+#include <LR35902/joypad/joypad.h>
+#include <backend/Emu.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs many headless machines at once. The machines are spread over a pool of threads, one per core and pinned to it
+// where the platform allows, and a thread that runs out of machines steals from the others. Every tick() runs each
+// machine for the same budget, applying the inputs fed to it first and calling its callback after, on the thread that
+// ran it. Machines share nothing, so the results don't depend on the number of threads or on who ran what.
+//
+// add(), feed(), onComplete() and the machines themselves are to be touched between ticks only.
+class BatchRunner {
+public:
+  struct budget {
+    enum unit { frames, cycles };
+
+    unit in = frames;
+    std::uint64_t amount = 1;
+  };
+
+  struct input {
+    lr::button btn;
+    lr::keystatus status;
+  };
+
+  using callback = std::function<void(std::size_t id, Emu &emu)>;
+
+  explicit BatchRunner(std::size_t threads = std::thread::hardware_concurrency(), bool pin = true);
+  ~BatchRunner();
+
+  BatchRunner(const BatchRunner &) = delete;
+  BatchRunner &operator=(const BatchRunner &) = delete;
+
+  // Plugs the ROM into a new machine past the boot ROM. Returns its id, nullopt if the ROM can't be loaded.
+  [[nodiscard]] std::optional<std::size_t> add(const std::string &rom);
+
+  [[nodiscard]] Emu &operator[](std::size_t id) noexcept;
+  [[nodiscard]] std::size_t size() const noexcept;
+  [[nodiscard]] std::size_t threads() const noexcept;
+
+  // the inputs applied to the machine at the start of the next tick, in order
+  void feed(std::size_t id, std::vector<input> inputs);
+
+  void onComplete(std::size_t id, callback f);
+
+  // Runs every machine for the budget, returns once all are done.
+  void tick(budget b);
+
+private:
+  struct instance {
+    std::unique_ptr<Emu> emu;
+    std::vector<input> inputs;
+    callback done;
+  };
+
+  struct queue {
+    std::mutex lock;
+    std::deque<std::size_t> ids;
+  };
+
+  std::vector<instance> m_instances;
+  std::vector<std::unique_ptr<queue>> m_queues; // one per worker
+  std::vector<std::jthread> m_workers;
+
+  std::mutex m_lock;
+  std::condition_variable m_start;
+  std::condition_variable m_finish;
+  std::uint64_t m_generation = 0; // bumped by every tick, wakes the workers up
+  std::size_t m_remaining = 0;    // machines left in this tick
+  budget m_budget;
+  bool m_quit = false;
+
+  void work(std::size_t self);
+  [[nodiscard]] std::optional<std::size_t> take(std::size_t self);
+  void run(std::size_t id);
+};
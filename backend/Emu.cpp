@@ -1,8 +1,16 @@
 #include <LR35902/config.h>
+#include <LR35902/cpu/recompiled.h>
 #include <backend/Emu.h>
 
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+
 bool Emu::tryBoot() noexcept {
-  return cart.loadBootROM();
+  const bool is_loaded = cart.loadBootROM();
+  bus.remap();
+  return is_loaded;
 }
 
 void Emu::skipBoot() noexcept {
@@ -11,18 +19,41 @@ void Emu::skipBoot() noexcept {
 }
 
 bool Emu::plug(const std::string &rom) noexcept {
-  return cart.loadROM(rom.data());
+  const bool is_loaded = cart.loadROM(rom.data());
+  bus.remap();
+  return is_loaded;
+}
+
+bool Emu::attach(const lr::recompiled_rom &recompiled) noexcept {
+  const std::span<const lr::byte> rom{cart.data(), cart.size()};
+  if(recompiled.rom_size != rom.size() || recompiled.checksum != lr::recompiled_checksum(rom)) return false;
+
+  cpu.attach(recompiled.blocks);
+  return true;
 }
 
 constexpr int vblank_period_cycles = 1140;
 
 int Emu::step() noexcept {
-  cpu.run();
-  const int cycles = clock.latest();
-  ppu.update(cycles);
-  timer.update(cycles);
+  const std::uint64_t begin = clock.data();
+
+  cpu.runUntilDeadline();
+  scheduler.sync();
+
+  return static_cast<int>(clock.data() - begin);
+}
+
+std::uint64_t Emu::run(const std::uint64_t cycles) noexcept {
+  const std::uint64_t begin = clock.data();
+  const std::uint64_t end = begin + cycles;
+
+  scheduler.limit(end); // held over the syncs the bus does in between
+  while(clock.data() < end) {
+    step();
+  }
+  scheduler.limit(std::nullopt);
 
-  return cycles;
+  return clock.data() - begin;
 }
 
 void Emu::update() noexcept {
@@ -36,6 +67,36 @@ void Emu::update() noexcept {
   }
 }
 
+lr::SaveState Emu::saveState() noexcept {
+  return lr::SaveState{{cpu, scheduler, bus, machine, ppu, cart}};
+}
+
+void Emu::save(std::vector<lr::byte> &out) {
+  saveState().save(out);
+}
+
+bool Emu::load(const std::span<const lr::byte> state) noexcept {
+  return saveState().load(state);
+}
+
+std::unique_ptr<Emu> Emu::clone() {
+  auto other = std::make_unique<Emu>();
+  cloneInto(*other);
+  return other;
+}
+
+void Emu::cloneInto(Emu &other) {
+  other.machine = machine;
+  other.cart = cart; // the ROM by reference, the rest of the cartridge by value
+  other.cpu = cpu;
+  other.ppu = ppu;
+  other.m_state = m_state;
+
+  // what is derived from the state
+  other.bus.remap(); // the page table, and a new version of every page drops the decoded blocks
+  other.scheduler.reschedule();
+}
+
 void Emu::reset() noexcept {
   cart.reset();
   ppu.reset();
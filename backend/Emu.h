@@ -8,9 +8,16 @@
 #include <LR35902/io/io.h>
 #include <LR35902/joypad/joypad.h>
 #include <LR35902/ppu/ppu.h>
+#include <LR35902/savestate/savestate.h>
+#include <LR35902/scheduler/scheduler.h>
+#include <LR35902/state/state.h>
 #include <LR35902/timer/timer.h>
 
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 #if defined(WITH_DEBUGGER)
 namespace LR35902 {
@@ -22,35 +29,60 @@ namespace lr = LR35902;
 
 struct Emu {
   enum state { stopped, running };
-  mutable state m_state;
+  mutable state m_state = stopped;
 
-  lr::IO io;
-  lr::Interrupt intr{io};
-  lr::Joypad joypad{io, intr};
-  lr::PPU ppu{intr, io};
+  lr::State machine; // the memory and the counters, the components below work on their parts of it
+  lr::IO &io = machine.io;
+  lr::BuiltIn &builtIn = machine.builtIn;
 
-  lr::Clock clock;
-  lr::Cartridge cart;
-  lr::BuiltIn builtIn;
+  lr::Interrupt intr{machine};
+  lr::Joypad joypad{machine, intr};
+  lr::PPU ppu{intr, machine};
+
+  lr::Clock clock{machine};
+  lr::Cartridge cart{machine};
+
+  lr::Timer timer{machine, intr};
+  lr::Scheduler scheduler{machine, clock, ppu, timer};
 
   lr::DMA dma{cart, ppu, builtIn, clock};
-  lr::Bus bus{cart, ppu, builtIn, dma, io, intr, joypad};
-  lr::Timer timer{io, intr};
-  lr::CPU cpu{bus, clock};
+  lr::Bus bus{cart, ppu, builtIn, dma, io, intr, joypad, scheduler};
+  lr::CPU cpu{machine, bus, clock};
 
   bool tryBoot() noexcept;
   void skipBoot() noexcept;
   bool plug(const std::string &rom) noexcept;
 
+  // Runs the blocks gb.recomp compiled from the plugged ROM natively. Returns false and keeps interpreting if they were
+  // compiled from another ROM. The boot ROM is interpreted while it is mapped.
+  bool attach(const lr::recompiled_rom &recompiled) noexcept;
+
   void update() noexcept;
 
   void reset() noexcept;
   void resume() noexcept;
   void stop() noexcept;
 
+  // Runs the CPU up to the next scheduled event, then lets the PPU and the timer catch up. Returns the cycles passed.
   [[maybe_unused]]
   int step() noexcept;
+
+  // Snapshots the whole machine into out, reusing its memory. load() restores one taken from the same ROM, it returns
+  // false and changes nothing otherwise. See LR35902::SaveState for the format.
+  void save(std::vector<lr::byte> &out);
+  [[nodiscard]] bool load(std::span<const lr::byte> state) noexcept;
+
+  // Another machine in the same state, to branch off from this one. The ROM is only read so it is shared rather than
+  // copied, along with the recompiled blocks attached. cloneInto() reuses a machine, e.g. one of a pool of children.
+  [[nodiscard]] std::unique_ptr<Emu> clone();
+  void cloneInto(Emu &other);
+
+  // Runs for the given machine cycles, stopping at the first instruction boundary past them. Returns the cycles passed.
+  std::uint64_t run(std::uint64_t cycles) noexcept;
 #if defined(WITH_DEBUGGER)
   friend class LR35902::DebugView;
 #endif
+
+private:
+  [[nodiscard]] lr::SaveState saveState() noexcept;
 };
@@ -0,0 +1,120 @@
+#include <backend/Rewind.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace {
+
+void putLength(std::vector<lr::byte> &out, std::size_t n) {
+  for(; n >= 0x80; n >>= 7)
+    out.push_back(static_cast<lr::byte>(n | 0x80));
+  out.push_back(static_cast<lr::byte>(n));
+}
+
+std::size_t getLength(const lr::byte *&in) noexcept {
+  std::size_t n = 0;
+  for(int shift = 0;; shift += 7) {
+    const lr::byte b = *in++;
+    n |= std::size_t{b & 0x7fu} << shift;
+    if(!(b & 0x80)) return n;
+  }
+}
+
+}
+
+Rewind::Rewind(const std::size_t budget) :
+    m_ring(budget) {}
+
+void Rewind::push(Emu &emu) {
+  emu.save(m_next);
+
+  if(m_latest.size() != m_next.size()) { // the first state, or another ROM
+    clear();
+    std::swap(m_latest, m_next);
+    return;
+  }
+
+  encode();
+  store();
+  std::swap(m_latest, m_next);
+}
+
+bool Rewind::back(Emu &emu) noexcept {
+  if(m_entries.empty()) return false;
+
+  const entry e = m_entries.back();
+  m_entries.pop_back();
+  m_head = e.offset;
+
+  const lr::byte *in = m_ring.data() + e.offset;
+  for(std::size_t i = 0; i != m_latest.size();) {
+    i += getLength(in);
+
+    const std::size_t changed = getLength(in);
+    for(const std::size_t end = i + changed; i != end; ++i)
+      m_latest[i] ^= *in++;
+  }
+
+  return emu.load(m_latest);
+}
+
+std::size_t Rewind::size() const noexcept {
+  return m_entries.size();
+}
+
+std::size_t Rewind::used() const noexcept {
+  std::size_t total = 0;
+  for(const entry &e : m_entries)
+    total += e.size;
+  return total;
+}
+
+void Rewind::clear() noexcept {
+  m_entries.clear();
+  m_head = 0;
+  m_latest.clear();
+}
+
+void Rewind::encode() {
+  m_delta.clear();
+
+  const std::size_t size = m_latest.size();
+  for(std::size_t i = 0; i != size;) {
+    const std::size_t same = i;
+    while(i != size && m_latest[i] == m_next[i])
+      ++i;
+    putLength(m_delta, i - same);
+
+    const std::size_t changed = i;
+    while(i != size && m_latest[i] != m_next[i])
+      ++i;
+    putLength(m_delta, i - changed);
+
+    for(std::size_t j = changed; j != i; ++j)
+      m_delta.push_back(m_latest[j] ^ m_next[j]);
+  }
+}
+
+void Rewind::store() {
+  const std::size_t size = m_delta.size();
+  if(size > m_ring.size()) { // doesn't fit even alone, nothing before this state can be reached anymore
+    m_entries.clear();
+    m_head = 0;
+    return;
+  }
+
+  if(m_head + size > m_ring.size()) { // wrap, giving up the end of the ring along with the oldest entries there
+    while(!m_entries.empty() && m_entries.front().offset >= m_head)
+      m_entries.pop_front();
+    m_head = 0;
+  }
+
+  const auto overlaps = [&](const entry &e) { return e.offset < m_head + size && m_head < e.offset + e.size; };
+  while(!m_entries.empty() && overlaps(m_entries.front()))
+    m_entries.pop_front();
+
+  std::ranges::copy(m_delta, m_ring.begin() + static_cast<std::ptrdiff_t>(m_head));
+  m_entries.push_back({m_head, size});
+  m_head += size;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <LR35902/config.h>
+#include <backend/Emu.h>
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+// Steps a machine back frame by frame. push() records its state, once a frame, back() restores the one recorded before
+// the last one.
+//
+// Only the newest state is kept in full. Each older one is kept as the XOR of it and the next newer one, so going back
+// is applying the newest delta to the newest state, and the oldest delta can be dropped at any time. Most of a machine
+// doesn't change from one frame to the next, a delta is mostly zeros and is stored as runs: the length of the zeros,
+// then the length and the bytes of what follows up to the next zero run.
+//
+// The deltas live in a ring of a fixed size, the oldest ones are dropped to make room for the new ones.
+class Rewind {
+public:
+  explicit Rewind(std::size_t budget);
+
+  void push(Emu &emu);
+
+  // restores the state recorded before the last one, false if there is none
+  bool back(Emu &emu) noexcept;
+
+  // the number of times back() can succeed
+  [[nodiscard]] std::size_t size() const noexcept;
+
+  // the bytes of the ring in use, out of the budget
+  [[nodiscard]] std::size_t used() const noexcept;
+
+  void clear() noexcept;
+
+private:
+  struct entry {
+    std::size_t offset;
+    std::size_t size;
+  };
+
+  std::vector<lr::byte> m_ring;
+  std::deque<entry> m_entries; // oldest first, laid out in the ring in the same order
+  std::size_t m_head = 0;      // where the next entry goes
+
+  std::vector<lr::byte> m_latest; // the newest state
+  std::vector<lr::byte> m_next;   // the state being pushed
+  std::vector<lr::byte> m_delta;  // from m_next to m_latest, encoded
+
+  void encode();
+  void store();
+};
@@ -2,6 +2,7 @@
 
 #include <LR35902/debugView/debugView.h>
 #include <backend/Emu.h>
+#include <backend/Rewind.h>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -58,6 +59,8 @@ void Debugger::onKey(int key, int action, int mods) {
     if(key == GLFW_KEY_DOWN) emulator->joypad.update(LR35902::button::down, LR35902::keystatus::pressed);
     if(key == GLFW_KEY_LEFT) emulator->joypad.update(LR35902::button::left, LR35902::keystatus::pressed);
 
+    if(key == GLFW_KEY_BACKSPACE) rewinding = true;
+
     break;
 
   case GLFW_RELEASE:
@@ -71,6 +74,8 @@ void Debugger::onKey(int key, int action, int mods) {
     if(key == GLFW_KEY_RIGHT) emulator->joypad.update(LR35902::button::right, LR35902::keystatus::released);
     if(key == GLFW_KEY_DOWN) emulator->joypad.update(LR35902::button::down, LR35902::keystatus::released);
     if(key == GLFW_KEY_LEFT) emulator->joypad.update(LR35902::button::left, LR35902::keystatus::released);
+
+    if(key == GLFW_KEY_BACKSPACE) rewinding = false;
     break;
 
   case GLFW_REPEAT:
@@ -160,6 +165,8 @@ void Debugger::init() {
 void Debugger::startup() {
   emulator = std::make_shared<Emu>();
   debugview = std::make_shared<LR::DebugView>(*emulator);
+  using LR::operator""_MiB;
+  rewind = std::make_shared<Rewind>(64_MiB);
 
   IMGUI_CHECKVERSION();
   ImGui::CreateContext();
@@ -238,7 +245,11 @@ void Debugger::render(double currentTime) {
   } break;
 
   case state_t::running: {
-    emulator->update();
+    if(rewinding) rewind->back(*emulator); // a frame back every frame, the last one recorded stays on screen once out
+    else {
+      emulator->update();
+      rewind->push(*emulator);
+    }
 
     if(debugview->_header) debugview->showCartHeader();
     if(debugview->_memory_portions) debugview->showMemoryPortions();
@@ -12,6 +12,7 @@
 #include <vector>
 
 struct Emu;
+class Rewind;
 
 namespace LR35902 {
 struct DebugView;
@@ -35,6 +36,8 @@ public:
 private:
   std::shared_ptr<Emu> emulator;
   std::shared_ptr<LR35902::DebugView> debugview;
+  std::shared_ptr<Rewind> rewind;
+  bool rewinding = false; // while backspace is held
 
   std::vector<std::string> romFiles;
 
@@ -2,6 +2,11 @@
 
 #include <LR35902/config.h>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
 namespace LR35902 {
 
 class Cartridge;
@@ -11,23 +16,88 @@ class IO;
 class Interrupt;
 class DMA;
 class Joypad;
+class Scheduler;
 
+// The address space is split into 256 pages of 256 bytes. A page whose backing memory can be accessed without any
+// side effect is mapped to a host pointer, and accessing it costs an indexed load. Pages left unmapped (nullptr) are
+// the ones with side effects, e.g. MBC registers, VRAM/OAM (locked during some PPU modes), IO and IE. These go
+// through the slow path.
+//
+// RAM pages that have decoded code on them (see BlockCache) are write protected, so a write there takes the slow
+// path, bumps the page version and lifts the protection. Any change of the memory map bumps the epoch.
+//
+// The slow path also lets the PPU and the timer catch up (see Scheduler) before an access to what they change.
 class Bus {
+public:
+  static constexpr std::size_t page_size = 256_B;
+  static constexpr std::size_t page_count = 64_KiB / page_size;
+
+private:
   Cartridge &m_cart;
   PPU &m_ppu;
   BuiltIn &m_builtIn;
   DMA &m_dma;
   IO &m_io;
   Joypad &m_joypad;
+  Scheduler &m_scheduler;
+
+  std::array<const byte *, page_count> m_readable{};
+  std::array<byte *, page_count> m_writable{};
+
+  std::array<byte *, page_count> m_ram{};
+  std::array<std::uint32_t, page_count> m_version{};
+  std::uint32_t m_epoch{};
+
+  [[nodiscard]] byte readSlow(const address_t index) const noexcept;
+  void writeSlow(const address_t index, const byte b) noexcept;
+
+  void mapCartridge() noexcept; // the selected ROM and RAM banks, redone on each write to the MBC registers
 
 public:
   Interrupt &interruptHandler;
 
 public:
-  [[nodiscard]] Bus(Cartridge &cart, PPU &ppu, BuiltIn &builtIn, DMA &dma, IO &io, Interrupt &interrupt, Joypad &joypad);
+  [[nodiscard]] Bus(Cartridge &cart, PPU &ppu, BuiltIn &builtIn, DMA &dma, IO &io, Interrupt &interrupt, Joypad &joypad,
+                    Scheduler &scheduler);
+
+  [[nodiscard]] byte read(const address_t index) const noexcept {
+    if(const byte *const page = m_readable[index / page_size]) return page[index % page_size];
+    return readSlow(index);
+  }
+
+  void write(const address_t index, const byte b) noexcept {
+    if(byte *const page = m_writable[index / page_size]) page[index % page_size] = b;
+    else writeSlow(index, b);
+  }
+
+  // rebuilds the page table, call it after a ROM plugged
+  void remap() noexcept;
+
+  // host memory of the page the index falls in, nullptr if it can't be accessed directly
+  [[nodiscard]] const byte *page(const address_t index) const noexcept {
+    return m_readable[index / page_size];
+  }
+
+  // where the index falls in the ROM file, considering the selected bank; nullopt if it isn't mapped to the ROM
+  [[nodiscard]] std::optional<std::size_t> romOffset(const address_t index) const noexcept;
+
+  [[nodiscard]] std::uint32_t version(const address_t index) const noexcept {
+    return m_version[index / page_size];
+  }
+
+  [[nodiscard]] std::uint32_t epoch() const noexcept {
+    return m_epoch;
+  }
+
+  // call it when the memory under index changed without going through write(), e.g. edited from the debugger
+  void invalidate(const address_t index) noexcept {
+    ++m_version[index / page_size];
+    ++m_epoch;
+  }
 
-  [[nodiscard]] byte read(const address_t index) const noexcept;
-  void write(const address_t index, const byte b) noexcept;
+  void protect(const address_t index) noexcept {
+    m_writable[index / page_size] = nullptr;
+  }
 
   void setPostBootValues() noexcept;
 };
@@ -10,23 +10,33 @@
 
 namespace LR35902 {
 
+struct State;
+
 // this things: https://en.wikipedia.org/wiki/ROM_cartridge#/media/File:PokemonSilverBoard.jpg
 class Cartridge final {
+  State &m_state; // the bank registers of the kinds are in it
   header_t header;
   using cart_t = std::variant<rom_only, rom_ram, mbc1, mbc2, mbc3, mbc5>;
   cart_t m_cart;
+  mutable open_bus m_open_bus; // what reads of the RAM of a cartridge without any return
 
   bool is_bootROM_successfully_loaded = false;
+  bool is_bootROM_mapped = false; // over the first 256 bytes of the ROM, until the write to 0xff50
   std::vector<byte> bootrom_buf;
-  std::vector<byte> dumpedGamePak;
 
 public:
+  explicit Cartridge(State &state) noexcept;
+
+  // Takes the cartridge of another machine over: the ROM is shared, the RAM copied. The bank registers come along
+  // with the State, this one stays plugged into its own machine.
+  Cartridge(const Cartridge &) = delete;
+  Cartridge &operator=(const Cartridge &other);
 
   bool loadBootROM() noexcept;
   bool loadROM(const char *const romfile) noexcept;
 
-  void mapBootROM() noexcept;
   void unmapBootROM() noexcept;
+  [[nodiscard]] const byte *bootROMData() const noexcept; // nullptr unless it's mapped
 
   [[nodiscard]] byte readROM(const address_t index) const noexcept;
   void writeROM(const address_t index, const byte b) noexcept;
@@ -39,9 +49,13 @@ public:
   [[nodiscard]] const byte *data() const noexcept;
   [[nodiscard]] std::size_t size() const noexcept;
 
+  [[nodiscard]] const byte *ROMXData() const noexcept; // currently selected bank, nullptr if it isn't in the ROM
+  [[nodiscard]] byte *SRAMXData() noexcept;             // same for the RAM, nullptr while it can't be accessed directly
+
   [[nodiscard]] std::optional<const byte *> SRAMData() const noexcept;
   [[nodiscard]] std::size_t SRAMSize() const noexcept;
 
   friend class DebugView;
+  friend class SaveState;
 };
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <LR35902/cartridge/kind/mbc_registers.h>
+#include <LR35902/cartridge/kind/rom.h>
 #include <LR35902/config.h>
 
 #include <cstddef>
@@ -9,26 +11,36 @@ namespace LR35902 {
 struct MBC_config;
 
 class mbc1 final {
-  std::vector<byte> m_rom;
+  rom_t m_rom;
   std::vector<byte> m_sram;
   bool has_sram;
   bool has_battery;
 
-  byte register_0 = 0;
-  byte register_1 = 0;
-  byte register_2 = 0;
-  byte register_3 = 0;
+  // in the mbc_registers, see mbc1.cpp
+  enum : std::size_t { register_0, register_1, register_2, register_3 };
+
+  // recomputed on register writes
+  std::size_t romx_offset = 0;
+  std::size_t sramx_offset = 0;
+
+  mutable open_bus m_open_bus; // what reads of disabled RAM return
+
+  void select_banks(const mbc_registers &r) noexcept;
 
 public:
-  mbc1(std::vector<byte> other, const MBC_config& config);
+  mbc1(rom_t other, const MBC_config& config, mbc_registers &r);
 
   [[nodiscard]] byte readROM(const address_t index) const noexcept;
-  void writeROM(const address_t index, const byte b) noexcept;
+  void writeROM(mbc_registers &r, const address_t index, const byte b) noexcept;
+  [[nodiscard]] const byte *romxData() const noexcept;
+  // the selected RAM bank, nullptr while it can't be accessed as memory
+  [[nodiscard]] byte *sramxData(const mbc_registers &r) noexcept;
 
-  [[nodiscard]] byte readSRAM(address_t index) const noexcept;
-  void writeSRAM(address_t index, const byte b) noexcept;
+  [[nodiscard]] byte readSRAM(const mbc_registers &r, address_t index) const noexcept;
+  void writeSRAM(const mbc_registers &r, address_t index, const byte b) noexcept;
 
   friend class Cartridge;
+  friend class SaveState;
 };
 
 }
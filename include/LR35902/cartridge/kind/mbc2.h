@@ -1,5 +1,7 @@
 #pragma once
 
+#include <LR35902/cartridge/kind/mbc_registers.h>
+#include <LR35902/cartridge/kind/rom.h>
 #include <LR35902/config.h>
 
 #include <array>
@@ -10,23 +12,31 @@ namespace LR35902 {
 struct MBC_config;
 
 class mbc2 final {
-  std::vector<byte> m_rom;
+  rom_t m_rom;
   std::array<byte, 512_B> m_sram{};
   bool has_battery;
 
-  byte rom_bank = 1;
-  bool ram_enabled = false;
+  // in the mbc_registers
+  enum : std::size_t { rom_bank, ram_enabled };
+
+  std::size_t romx_offset = 0; // recomputed on register writes
+
+  mutable open_bus m_open_bus; // what reads of disabled RAM return
+
+  void select_banks(const mbc_registers &r) noexcept;
 
 public:
-   mbc2(std::vector<byte> rom, const MBC_config& config);
+   mbc2(rom_t rom, const MBC_config& config, mbc_registers &r);
 
   [[nodiscard]] byte readROM(const address_t index) const noexcept;
-   void writeROM(const address_t index, const byte b) noexcept;
+   void writeROM(mbc_registers &r, const address_t index, const byte b) noexcept;
+   [[nodiscard]] const byte *romxData() const noexcept;
 
-  [[nodiscard]] byte readSRAM(address_t index) const noexcept;
-   void writeSRAM(address_t index, const byte b) noexcept;
+  [[nodiscard]] byte readSRAM(const mbc_registers &r, address_t index) const noexcept;
+   void writeSRAM(const mbc_registers &r, address_t index, const byte b) noexcept;
 
   friend class Cartridge;
+  friend class SaveState;
 };
 
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <LR35902/cartridge/kind/mbc_registers.h>
+#include <LR35902/cartridge/kind/rom.h>
 #include <LR35902/config.h>
 
 #include <cstddef>
@@ -30,17 +32,22 @@ template <std::size_t N>
 using circularByteBuffer = CircularBuffer<byte, N>;
 
 class mbc3 final {
-  std::vector<byte> m_rom;
+  rom_t m_rom;
   std::vector<byte> m_sram;
 
   bool has_timer;
   bool has_battery;
 
-  // registers
-  byte SRAM_enabled = 0;
-  byte ROM_bank = 1;
-  byte SRAM_bank = 0;
-  byte latch = 0;
+  // in the mbc_registers
+  enum : std::size_t { SRAM_enabled, ROM_bank, SRAM_bank, latch };
+
+  // recomputed on register writes
+  std::size_t romx_offset = 0;
+  std::size_t sramx_offset = 0;
+
+  mutable open_bus m_open_bus; // what reads of disabled RAM return
+
+  void select_banks(const mbc_registers &r) noexcept;
 
   struct RTC_t {
     byte seconds;
@@ -58,15 +65,19 @@ class mbc3 final {
   void update_RTC() noexcept;
 
 public:
-  mbc3(std::vector<byte> rom, const MBC_config& config);
+  mbc3(rom_t rom, const MBC_config& config, mbc_registers &r);
 
   [[nodiscard]] byte readROM(address_t index) const noexcept;
-  void writeROM(const address_t index, const byte b) noexcept;
+  void writeROM(mbc_registers &r, const address_t index, const byte b) noexcept;
+  [[nodiscard]] const byte *romxData() const noexcept;
+  // the selected RAM bank, nullptr while it can't be accessed as memory
+  [[nodiscard]] byte *sramxData(const mbc_registers &r) noexcept;
 
-  [[nodiscard]] byte readSRAM(address_t index) const noexcept;
-  void writeSRAM(address_t index, const byte b) noexcept;
+  [[nodiscard]] byte readSRAM(const mbc_registers &r, address_t index) const noexcept;
+  void writeSRAM(const mbc_registers &r, address_t index, const byte b) noexcept;
 
   friend class Cartridge;
+  friend class SaveState;
 };
 
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <LR35902/cartridge/kind/mbc_registers.h>
+#include <LR35902/cartridge/kind/rom.h>
 #include <LR35902/config.h>
 
 #include <cstddef>
@@ -9,28 +11,38 @@ namespace LR35902 {
 struct MBC_config;
 
 class mbc5 final {
-  std::vector<byte> m_rom;
+  rom_t m_rom;
   std::vector<byte> m_sram;
   bool has_battery;
   bool has_rumble;
 
+  // in the mbc_registers, all 0 at power on
   // REVISIT: Are these correct default values for the registers?
-  byte ramg = 0;
-  byte romb_0 = 0;
-  byte romb_1 = 0;
-  byte ramb = 0;
+  enum : std::size_t { ramg, romb_0, romb_1, ramb };
+
+  // recomputed on register writes
+  std::size_t romx_offset = 0;
+  std::size_t sramx_offset = 0;
+
+  mutable open_bus m_open_bus; // what reads of disabled RAM return
+
+  void select_banks(const mbc_registers &r) noexcept;
 
 public:
-  mbc5(std::vector<byte> other, const MBC_config& config);
+  mbc5(rom_t other, const MBC_config& config, mbc_registers &r);
 
   [[nodiscard]] byte readROM(const address_t index) const noexcept;
-  void writeROM(const address_t index, const byte b) noexcept;
+  void writeROM(mbc_registers &r, const address_t index, const byte b) noexcept;
+  [[nodiscard]] const byte *romxData() const noexcept;
+  // the selected RAM bank, nullptr while it can't be accessed as memory
+  [[nodiscard]] byte *sramxData(const mbc_registers &r) noexcept;
 
-  [[nodiscard]] byte readSRAM(address_t index) const noexcept;
-  void writeSRAM(address_t index, const byte b) noexcept;
+  [[nodiscard]] byte readSRAM(const mbc_registers &r, address_t index) const noexcept;
+  void writeSRAM(const mbc_registers &r, address_t index, const byte b) noexcept;
 
 
   friend class Cartridge;
+  friend class SaveState;
 };
 
 }
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <LR35902/config.h>
+
+#include <array>
+
+namespace LR35902 {
+
+// The registers a memory bank controller latches from the writes into its ROM. No kind has more than four, each names
+// them after its documentation. They're kept in the State of the machine and handed to the kind.
+using mbc_registers = std::array<byte, 4>;
+
+}
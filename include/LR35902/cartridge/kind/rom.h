@@ -0,0 +1,53 @@
+#pragma once
+
+#include <LR35902/config.h>
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace LR35902 {
+
+// The bytes of a ROM, never written once loaded. A file is mapped into memory read only rather than read into it: loading
+// takes no time whatever the size of the ROM, and the machines running the same file share its pages, in this process
+// or not. The machines cloned from one another share the image itself. The file mustn't change while it is mapped.
+class rom_image {
+  const byte *m_data = nullptr;
+  std::size_t m_size = 0;
+  bool m_mapped = false;
+  std::vector<byte> m_owned; // the bytes if they aren't mapped
+
+  rom_image() = default;
+
+public:
+  // nullptr if the file can't be read or is empty
+  [[nodiscard]] static std::shared_ptr<const rom_image> open(const char *path);
+
+  // an image of bytes already in memory, e.g. a ROM with the boot ROM over its first bytes
+  [[nodiscard]] static std::shared_ptr<const rom_image> copy(std::vector<byte> bytes);
+
+  rom_image(const rom_image &) = delete;
+  rom_image &operator=(const rom_image &) = delete;
+  ~rom_image();
+
+  [[nodiscard]] byte operator[](const std::size_t index) const noexcept {
+    return m_data[index];
+  }
+
+  [[nodiscard]] const byte *data() const noexcept {
+    return m_data;
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return m_size;
+  }
+
+  [[nodiscard]] std::span<const byte> bytes() const noexcept {
+    return {m_data, m_size};
+  }
+};
+
+using rom_t = std::shared_ptr<const rom_image>;
+
+}
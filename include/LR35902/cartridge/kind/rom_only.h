@@ -1,5 +1,7 @@
 #pragma once
 
+#include <LR35902/cartridge/kind/mbc_registers.h>
+#include <LR35902/cartridge/kind/rom.h>
 #include <LR35902/config.h>
 
 #include <cstdint>
@@ -8,16 +10,17 @@
 namespace LR35902 {
 
 class rom_only final {
-  std::vector<byte> m_rom;
+  rom_t m_rom = rom_image::copy({}); // empty until a ROM is plugged
 
 public:
   explicit rom_only() = default;
 
-  explicit rom_only(std::vector<byte> rom) :
+  explicit rom_only(rom_t rom) :
       m_rom(std::move(rom)) {}
 
   [[nodiscard]] byte readROM(const address_t index) const noexcept;
-  void writeROM(const address_t index, const byte b) noexcept;
+  void writeROM(mbc_registers &, const address_t index, const byte b) noexcept;
+  [[nodiscard]] const byte *romxData() const noexcept;
 
   friend class Cartridge;
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <LR35902/cartridge/kind/mbc_registers.h>
+#include <LR35902/cartridge/kind/rom.h>
 #include <LR35902/config.h>
 
 #include <array>
@@ -9,21 +11,25 @@ namespace LR35902 {
 struct MBC_config;
 
 class rom_ram final {
-  std::vector<byte> m_rom; // Usually 32KiB
+  rom_t m_rom; // Usually 32KiB
   std::array<byte, 8_KiB> m_sram{};
 
   bool has_battery;
 
 public:
-  rom_ram(std::vector<byte> rom, const MBC_config& config);
+  rom_ram(rom_t rom, const MBC_config& config);
 
   [[nodiscard]] byte readROM(const address_t index) const noexcept;
-  void writeROM(const address_t index, const byte b) noexcept;
+  void writeROM(mbc_registers &, const address_t index, const byte b) noexcept;
+  [[nodiscard]] const byte *romxData() const noexcept;
+  // the selected RAM bank, nullptr while it can't be accessed as memory
+  [[nodiscard]] byte *sramxData(const mbc_registers &) noexcept;
 
-  [[nodiscard]] byte readSRAM(const address_t index) const noexcept;
-  void writeSRAM(const address_t index, const byte b) noexcept;
+  [[nodiscard]] byte readSRAM(const mbc_registers &, const address_t index) const noexcept;
+  void writeSRAM(const mbc_registers &, const address_t index, const byte b) noexcept;
 
   friend class Cartridge;
+  friend class SaveState;
 };
 
 }
@@ -32,10 +32,17 @@ using address_t = std::uint16_t;
   return 8_KiB * l;
 }
 
-inline std::mt19937 engine{std::random_device{}()};
-inline std::uniform_int_distribution get{0, 255};
-[[nodiscard]] inline byte random_byte() {
-  return get(engine);
-}
+// What a read from nowhere (e.g. disabled cartridge RAM) returns: noise. Every component that has such reads owns one,
+// so that machines don't share any state and a run is reproducible.
+class open_bus {
+  std::minstd_rand m_engine;
+
+public:
+  [[nodiscard]] byte read() noexcept {
+    return static_cast<byte>(m_engine() >> 16);
+  }
+
+  friend class SaveState;
+};
 
 } // namespace LR35902
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <LR35902/bus/bus.h>
+#include <LR35902/config.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace LR35902 {
+
+// an instruction decoded once, along with its immediate (or the opcode after the 0xCB prefix)
+struct micro_op {
+  byte opcode;
+  std::array<byte, 2> operand;
+};
+
+class CPU;
+
+// executes a decoded instruction, returns true if the block it is part of has to be left right after it
+using handler_t = bool (*)(CPU &, const micro_op &) noexcept;
+
+// number of bytes the instruction takes with its immediate, 0xCB counts the prefixed opcode as its immediate
+[[nodiscard]] std::size_t instruction_length(const byte opcode) noexcept;
+
+// Decodes the straight-line code starting at code into ops, without reading more than the available bytes. Returns the
+// number of micro ops decoded.
+std::size_t decode(const byte *const code, const std::size_t available, std::span<micro_op> ops) noexcept;
+
+// Straight-line guest code is decoded into blocks of micro ops that end with the first jump, call, return, rst, halt
+// or stop. Blocks are keyed by the host address of their first byte, so the same PC in different ROM banks doesn't
+// collide, and are checked against the page version the Bus keeps. The code outside of the directly accessible pages
+// (see Bus) isn't cached, it is decoded through the bus on every fetch as before.
+class BlockCache {
+public:
+  static constexpr std::size_t block_count = 1024;
+  static constexpr std::size_t max_block_length = 32;
+
+private:
+  struct block_t {
+    const byte *key = nullptr;
+    std::uint32_t version{};
+    std::uint8_t length{};
+    std::array<micro_op, max_block_length> ops;
+  };
+
+  Bus &m_bus;
+  std::vector<block_t> m_blocks; // direct mapped
+
+  micro_op m_uncached{};
+  const micro_op *m_next = nullptr;
+  const micro_op *m_end = nullptr;
+  std::uint32_t m_epoch{};
+
+  const micro_op *enter(const address_t pc) noexcept;
+
+public:
+  explicit BlockCache(Bus &bus);
+
+  // the instruction at pc, which is expected to follow the previous one unless leave() called in between
+  [[nodiscard]] const micro_op *fetch(const address_t pc) noexcept {
+    if(m_next == m_end || m_epoch != m_bus.epoch()) [[unlikely]]
+      return enter(pc);
+    return m_next++;
+  }
+
+  // whether the next fetch starts a new block
+  [[nodiscard]] bool atBoundary() const noexcept {
+    return m_next == m_end || m_epoch != m_bus.epoch();
+  }
+
+  // call it when the control flow changes outside of an instruction, e.g. an interrupt dispatched
+  void leave() noexcept {
+    m_next = m_end;
+  }
+};
+
+}
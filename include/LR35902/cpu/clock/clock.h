@@ -1,25 +1,44 @@
 #pragma once
 
+#include <LR35902/state/state.h>
+
 #include <cstddef>
+#include <cstdint>
 
 namespace LR35902 {
 
+// Counts the machine cycles since power on. The CPU stops once the count reaches the deadline, which the Scheduler
+// moves to the next point where some other component has something to do. The counters are in the State.
 class Clock {
-  std::size_t m_data{};
-  std::size_t m_latest{};
+  State &m_state;
 
 public:
+  explicit Clock(State &state) noexcept :
+      m_state{state} {}
+
   void cycle(const std::size_t m) {
-    m_latest = m;
-    m_data += m;
+    m_state.latest = m;
+    m_state.cycles += m;
   }
 
-  [[nodiscard]] auto data() const noexcept -> std::size_t {
-    return m_data;
+  [[nodiscard]] auto data() const noexcept -> std::uint64_t {
+    return m_state.cycles;
   }
 
   [[nodiscard]] auto latest() const noexcept -> std::size_t {
-    return m_latest;
+    return m_state.latest;
+  }
+
+  [[nodiscard]] auto deadline() const noexcept -> std::uint64_t {
+    return m_state.deadline;
+  }
+
+  void deadline(const std::uint64_t at) noexcept {
+    m_state.deadline = at;
+  }
+
+  [[nodiscard]] bool due() const noexcept {
+    return m_state.cycles >= m_state.deadline;
   }
 
   friend class DebugView;
@@ -1,14 +1,25 @@
 #pragma once
 
+#include <LR35902/cpu/block_cache.h>
 #include <LR35902/cpu/clock/clock.h>
 #include <LR35902/cpu/immediate/e8.h>
 #include <LR35902/cpu/immediate/n16.h>
 #include <LR35902/cpu/immediate/n8.h>
 #include <LR35902/cpu/immediate/u3.h>
+#include <LR35902/cpu/recompiled.h>
 #include <LR35902/cpu/registers/cc.h>
 #include <LR35902/cpu/registers/flags.h>
+#include <LR35902/cpu/registers/lazy_flags.h>
 #include <LR35902/cpu/registers/r16.h>
 #include <LR35902/cpu/registers/r8.h>
+#include <LR35902/cpu/registers/register_file.h>
+#include <LR35902/state/state.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
 
 #if defined(WITH_DEBUGGER)
   #include <variant>
@@ -20,24 +31,117 @@ namespace LR35902 {
 // https://rgbds.gbdev.io/docs/v0.5.2/gbz80.7
 class CPU {
 private:
-  Bus m_bus;
+  // The register file is in the State of the machine, the instructions name its registers through these
+  register_file &m_registers;
+  n16 &SP = m_registers.SP;
+  n16 &PC = m_registers.PC;
+  r8 &C = m_registers.C, &B = m_registers.B;
+  r8 &E = m_registers.E, &D = m_registers.D;
+  r8 &L = m_registers.L, &H = m_registers.H;
+  r8 &A = m_registers.A;
+  flags &F = m_registers.F;
+  flag &ime = m_registers.ime;
+
+  Bus &m_bus;
+  BlockCache m_blocks;
+  const micro_op *m_op = nullptr; // the instruction being executed
+
+  // Code running outside of the interpreter (a recompiled block) executes the instructions one by one through the
+  // handlers, and leaves the block as soon as the epoch of the bus differs from the one it was entered with
+  std::uint32_t m_block_epoch{};
+  std::span<const recompiled_block> m_recompiled;
+
+  template <std::uint8_t Opcode>
+  void execute() noexcept;
+
+  void interpret(std::size_t instructions) noexcept;
+  void runRecompiled(std::size_t instructions) noexcept;
+  [[nodiscard]] const recompiled_block *findRecompiled() const noexcept;
+
+  // A loop that only reads memory and compares what it read goes around exactly the same way until an event changes
+  // the memory, so whole iterations up to the deadline are skipped at once. The loop is the one a backward jump just
+  // closed, its period is measured over the passes and has to repeat, with no event passed in between, before anything
+  // is skipped.
+  struct idle_loop_t {
+    const byte *code = nullptr; // host address of the loop's first instruction, along with the page version
+    std::uint32_t version{};
+    word bc{}, de{}, hl{}; // the pairs the loop may read memory through, the verdict holds for these addresses only
+    bool polling = false;
+    std::uint64_t last{}; // clock at the previous pass
+    std::uint64_t period{};
+    std::uint64_t deadline{}; // at the previous pass, a different one now means an event passed since
+  };
+
+  bool m_skip_idle_loops = true;
+  idle_loop_t m_idle_loop;
+  std::uint64_t m_skipped_cycles{};
+
+  std::uint64_t m_retired{}; // instructions executed since power on, by any core
+
+  void idleLoop(const address_t end) noexcept;
+  [[nodiscard]] bool isPollingLoop(const byte *const code, const std::size_t length) const noexcept;
+
+  // views on the pairs of the register file
+  r16 BC;
+  r16 DE;
+  r16 HL;
 
-  r8 A;
-  flags F;
+#if defined(LAZY_FLAGS)
+  lazy_flags m_lazy;
+#endif
 
-  r8 B, C;
-  r16 BC;
+  // The flags of 8-bit add, sub, inc and dec go through these. They're computed right away, or with LAZY_FLAGS,
+  // recorded and computed once read. Anything else touching F settles them first.
+  void addFlags(const byte a, const byte b, const flag carry) noexcept {
+#if defined(LAZY_FLAGS)
+    m_lazy.add(a, b, carry);
+#else
+    F = flags::ofAdd(a, b, carry);
+#endif
+  }
 
-  r8 D, E;
-  r16 DE;
+  void subFlags(const byte a, const byte b, const flag carry) noexcept {
+#if defined(LAZY_FLAGS)
+    m_lazy.sub(a, b, carry);
+#else
+    F = flags::ofSub(a, b, carry);
+#endif
+  }
 
-  r8 H, L;
-  r16 HL;
+  void incFlags(const byte a) noexcept {
+#if defined(LAZY_FLAGS)
+    m_lazy.inc(a, carry());
+#else
+    F = flags::ofInc(a, F.c);
+#endif
+  }
+
+  void decFlags(const byte a) noexcept {
+#if defined(LAZY_FLAGS)
+    m_lazy.dec(a, carry());
+#else
+    F = flags::ofDec(a, F.c);
+#endif
+  }
+
+  [[nodiscard]] flag carry() const noexcept {
+#if defined(LAZY_FLAGS)
+    if(m_lazy.pending()) return m_lazy.carry();
+#endif
+    return F.c;
+  }
 
-  n16 SP; // stack pointer
-  n16 PC; // program counter
+  void settleFlags() noexcept {
+#if defined(LAZY_FLAGS)
+    m_lazy.settle(F);
+#endif
+  }
 
-  flag ime{}; // interrupt master enable
+  void dropFlags() noexcept {
+#if defined(LAZY_FLAGS)
+    m_lazy.drop();
+#endif
+  }
   Clock &m_clock;
 
   auto fetchOpcode() noexcept -> byte;
@@ -48,7 +152,17 @@ private:
   void handleInterrupts() noexcept;
 
   enum class mode_t { running, halted, stopped };
-  mode_t mode;
+  mode_t mode = mode_t::running;
+
+  // The halt bug (see halt()): the next fetch reads the opcode without incrementing PC, so the byte after halt is read
+  // twice, as the opcode and as what follows it
+  bool m_halt_bug = false;
+  micro_op m_repeated{}; // the instruction decoded that way
+
+  // Halted, nothing happens until an interrupt is requested, which only an event of another component can do. The
+  // clock jumps to the deadline, the next of those events, so the run ends there.
+  void idle() noexcept;
+  [[nodiscard]] bool wake() noexcept;
 
 #if defined(WITH_DEBUGGER)
   using immediate_t = std::variant<std::monostate, byte, sbyte, word>;
@@ -70,18 +184,85 @@ private:
   // clang-format on
 
 public:
-  explicit CPU(Bus bus, Clock &clock) noexcept :
-      m_bus{std::move(bus)},
-      BC{m_bus, B, C},
-      DE{m_bus, D, E},
-      HL{m_bus, H, L},
+  CPU(State &state, Bus &bus, Clock &clock) noexcept :
+      m_registers{state.registers},
+      m_bus{bus},
+      m_blocks{bus},
+      BC{m_registers, offsetof(register_file, C)},
+      DE{m_registers, offsetof(register_file, E)},
+      HL{m_registers, offsetof(register_file, L)},
       m_clock{clock} {}
 
-  void run() noexcept;
+  // Takes over the state another machine's CPU keeps outside of the State: the mode, the pending halt bug, the
+  // counters and the recompiled blocks attached. The registers come along with the State.
+  CPU(const CPU &) = delete;
+  CPU &operator=(const CPU &other) noexcept;
+
+  void run() noexcept {
+    run(1);
+  }
+
+  // Executes the given number of instructions back to back, nothing else gets a chance to catch up in between. Stops
+  // early once the clock reaches its deadline.
+  void run(const std::size_t instructions) noexcept {
+    if(mode == mode_t::halted && !wake()) return;
+
+    if(m_recompiled.empty()) interpret(instructions);
+    else runRecompiled(instructions);
+  }
+
+  // executes until the clock reaches its deadline
+  void runUntilDeadline() noexcept {
+    run(std::numeric_limits<std::size_t>::max());
+  }
   void setPostBootValues() noexcept;
   void reset() noexcept;
 
+  // the blocks gb.recomp compiled from the plugged ROM, pass an empty span to interpret everything again
+  void attach(const std::span<const recompiled_block> blocks) noexcept {
+    m_recompiled = blocks;
+  }
+  [[nodiscard]] std::span<const recompiled_block> attached() const noexcept {
+    return m_recompiled;
+  }
+
+  // Executes op, which has the given opcode, as part of a block. Returns true if the block has to be left right after
+  // it. Defined in execute.h, the code gb.recomp emits calls it.
+  template <std::uint8_t Opcode>
+  static bool step(CPU &cpu, const micro_op &op) noexcept;
+
+  // step for every opcode, indexed by the opcode
+  [[nodiscard]] static const std::array<handler_t, 256> &handlers() noexcept;
+
+  void skipIdleLoops(const bool enabled) noexcept {
+    m_skip_idle_loops = enabled;
+    m_idle_loop = {};
+  }
+
+  // the cycles idle loops skipped so far
+  [[nodiscard]] std::uint64_t skippedCycles() const noexcept {
+    return m_skipped_cycles;
+  }
+
+  // the instructions executed so far
+  [[nodiscard]] std::uint64_t retired() const noexcept {
+    return m_retired;
+  }
+
+  // the programmer visible state, e.g. to compare recompiled code with the interpreter or to snapshot a machine
+  [[nodiscard]] const register_file &registers() noexcept {
+    settleFlags();
+    return m_registers;
+  }
+
+  void registers(const register_file &file) noexcept {
+    m_registers = file;
+    dropFlags();
+    m_blocks.leave();
+  }
+
   friend class DebugView;
+  friend class SaveState;
 
 private:
   // 8-bit Arithmetic and Logic Instructions
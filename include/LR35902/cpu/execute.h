@@ -0,0 +1,82 @@
+#pragma once
+
+#include <LR35902/bus/bus.h>
+#include <LR35902/config.h>
+#include <LR35902/cpu/cpu.h>
+#include <LR35902/interrupt/interrupt.h>
+#include <LR35902/memory_map.h>
+
+#include <cstdint>
+
+#if defined(WITH_DEBUGGER)
+  #include <variant>
+#endif
+
+// Every opcode gets a function of its own too, the recompiled code calls them one after another.
+// The definitions are in a header so the code gb.recomp emits can have them inlined, the opcode and its immediate
+// being constants there.
+
+namespace LR35902 {
+
+inline auto CPU::fetchsByte() noexcept -> sbyte {
+  ++PC.m_data;
+#if defined(WITH_DEBUGGER)
+  immediate = static_cast<std::int8_t>(m_op->operand[0]);
+  return std::get<sbyte>(immediate);
+#endif
+  return m_op->operand[0];
+}
+
+inline auto CPU::fetchByte() noexcept -> byte {
+  ++PC.m_data;
+#if defined(WITH_DEBUGGER)
+  immediate = m_op->operand[0];
+  return std::get<byte>(immediate);
+#endif
+  return m_op->operand[0];
+}
+
+inline auto CPU::fetchWord() noexcept -> word {
+  PC.m_data += 2;
+  const byte lo = m_op->operand[0];
+  const byte hi = m_op->operand[1];
+#if defined(WITH_DEBUGGER)
+  immediate = word(hi << 8 | lo);
+  return std::get<word>(immediate);
+#endif
+  return word(hi << 8 | lo);
+}
+
+#define OPCODE(n) case n:
+#define CB_OPCODE(n) case n:
+#define CB_DISPATCH(b) switch(b)
+#define NEXT break
+
+template <std::uint8_t Opcode>
+void CPU::execute() noexcept {
+  switch(Opcode) {
+#include <LR35902/cpu/opcodes.inc>
+  }
+}
+
+#undef OPCODE
+#undef CB_OPCODE
+#undef CB_DISPATCH
+#undef NEXT
+
+template <std::uint8_t Opcode>
+bool CPU::step(CPU &cpu, const micro_op &op) noexcept {
+  cpu.m_op = &op;
+  ++cpu.PC.m_data;
+#if defined(WITH_DEBUGGER)
+  cpu.immediate = std::monostate{};
+  cpu.opcode = Opcode;
+#endif
+
+  cpu.execute<Opcode>();
+
+  return (cpu.ime && cpu.m_bus.interruptHandler.isThereAnAwaitingInterrupt()) || cpu.m_bus.epoch() != cpu.m_block_epoch ||
+         cpu.m_clock.due();
+}
+
+}
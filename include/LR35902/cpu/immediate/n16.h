@@ -38,6 +38,8 @@ struct n16 {
     --m_data;
     return *this;
   }
+
+  bool operator==(const n16 &) const = default;
 };
 
 } // namespace LR35902
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <LR35902/config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace LR35902 {
+
+class CPU;
+
+// A basic block compiled ahead of time by gb.recomp. Blocks are keyed by the offset of their first instruction in the
+// ROM file, so the same address in different banks doesn't collide.
+struct recompiled_block {
+  std::uint32_t rom_offset;
+  std::uint8_t length;                   // number of instructions
+  std::uint32_t (*code)(CPU &) noexcept; // returns the number of instructions executed
+};
+
+// What gb.recomp emits for a ROM. The blocks are sorted by their offset.
+struct recompiled_rom {
+  std::size_t rom_size;
+  word checksum; // the sum of all the bytes in the ROM, to tell whether the blocks were compiled from the plugged one
+  std::span<const recompiled_block> blocks;
+};
+
+// the checksum gb.recomp stores, computed the same way on both sides
+[[nodiscard]] constexpr word recompiled_checksum(std::span<const byte> rom) noexcept {
+  word sum{};
+  for(const byte b : rom)
+    sum = static_cast<word>(sum + b);
+  return sum;
+}
+
+}
@@ -23,6 +23,26 @@ struct flags {
   [[nodiscard]] byte data() const noexcept {
     return byte(z << 7 | n << 6 | h << 5 | c << 4);
   }
+
+  bool operator==(const flags &) const = default;
+
+  // z n h c of the 8-bit arithmetic, a being the accumulator (or the register incremented or decremented) before it
+  [[nodiscard]] static constexpr flags ofAdd(const byte a, const byte b, const flag carry) noexcept {
+    return {byte(a + b + carry) == 0, 0, (a & 0b0000'1111) + (b & 0b0000'1111) + carry > 0b0000'1111,
+            a + b + carry > 0b1111'1111};
+  }
+
+  [[nodiscard]] static constexpr flags ofSub(const byte a, const byte b, const flag carry) noexcept {
+    return {byte(a - b - carry) == 0, 1, (b & 0b0000'1111) + carry > (a & 0b0000'1111), b + carry > a};
+  }
+
+  [[nodiscard]] static constexpr flags ofInc(const byte a, const flag carry) noexcept {
+    return {byte(a + 1) == 0, 0, (byte(a + 1) & 0b0000'1111) == 0, carry};
+  }
+
+  [[nodiscard]] static constexpr flags ofDec(const byte a, const flag carry) noexcept {
+    return {byte(a - 1) == 0, 1, (byte(a - 1) & 0b0000'1111) == 0b0000'1111, carry};
+  }
 };
 
 } // namespace LR35902
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <LR35902/config.h>
+#include <LR35902/cpu/registers/flags.h>
+
+#include <cstdint>
+
+namespace LR35902 {
+
+// The flags of the last 8-bit add, sub, inc or dec kept as its operands, so the half carry, carry and zero flags are
+// computed only when something reads them: a conditional jump, adc/sbc, a rotate, daa, push AF or the debugger. Most
+// of the time the next arithmetic instruction overwrites them before that.
+class lazy_flags {
+  enum class kind : std::uint8_t { settled, add, sub, inc, dec };
+
+  kind m_kind = kind::settled;
+  byte m_a{};      // the accumulator (or the register incremented or decremented) before the instruction
+  byte m_b{};      // the other operand
+  flag m_carry{};  // the carry in for add and sub, the carry left untouched for inc and dec
+
+  void record(const kind k, const byte a, const byte b, const flag carry) noexcept {
+    m_kind = k;
+    m_a = a;
+    m_b = b;
+    m_carry = carry;
+  }
+
+public:
+  void add(const byte a, const byte b, const flag carry) noexcept {
+    record(kind::add, a, b, carry);
+  }
+
+  void sub(const byte a, const byte b, const flag carry) noexcept {
+    record(kind::sub, a, b, carry);
+  }
+
+  void inc(const byte a, const flag carry) noexcept {
+    record(kind::inc, a, byte{}, carry);
+  }
+
+  void dec(const byte a, const flag carry) noexcept {
+    record(kind::dec, a, byte{}, carry);
+  }
+
+  [[nodiscard]] bool pending() const noexcept {
+    return m_kind != kind::settled;
+  }
+
+  // only the carry, cheaper than evaluating all of them; valid while pending
+  [[nodiscard]] flag carry() const noexcept {
+    switch(m_kind) {
+    case kind::add: return flags::ofAdd(m_a, m_b, m_carry).c;
+    case kind::sub: return flags::ofSub(m_a, m_b, m_carry).c;
+    default: return m_carry;
+    }
+  }
+
+  // writes the flags of the recorded instruction into f, if there is one
+  void settle(flags &f) noexcept {
+    switch(m_kind) {
+    case kind::settled: return;
+    case kind::add: f = flags::ofAdd(m_a, m_b, m_carry); break;
+    case kind::sub: f = flags::ofSub(m_a, m_b, m_carry); break;
+    case kind::inc: f = flags::ofInc(m_a, m_carry); break;
+    case kind::dec: f = flags::ofDec(m_a, m_carry); break;
+    }
+    m_kind = kind::settled;
+  }
+
+  // forget the recorded instruction, e.g. the flags were overwritten as a whole
+  void drop() noexcept {
+    m_kind = kind::settled;
+  }
+};
+
+}
@@ -1,45 +1,85 @@
 #pragma once
 
 #include <LR35902/config.h>
+#include <LR35902/cpu/immediate/n16.h>
+#include <LR35902/cpu/registers/r8.h>
 
+#include <bit>
 #include <compare>
+#include <cstddef>
 #include <cstdint>
 
 namespace LR35902 {
-class r8;
-struct n16;
-class Bus;
 
+struct register_file;
+
+// A pair of 8-bit registers seen as one 16-bit register. The pair is stored in the register file low register first,
+// and is accessed through the bytes of it, so reading, incrementing and writing back a pair compiles to 16-bit loads,
+// adds and stores.
 class r16 {
 private:
-  Bus &m_bus;
+  byte *m_lo; // the high register follows
 
-  r8 &m_hi;
-  r8 &m_lo;
+  void assign(const std::uint16_t u) noexcept {
+    byte *const lo = m_lo; // a byte store may alias m_lo itself, keeps it from being loaded again in between
+    lo[0] = byte(u);
+    lo[1] = byte(u >> 8);
+  }
 
 public:
   r16() = delete;
-  r16(Bus &bus, r8 &hi, r8 &lo) :
-      m_bus{bus},
-      m_hi{hi},
-      m_lo{lo} {}
+  r16(register_file &file, const std::size_t lo_offset) noexcept :
+      m_lo{reinterpret_cast<byte *>(&file) + lo_offset} {}
 
-  r16 &operator=(const n16 nn) noexcept;
+  r16(const r16 &) = default;
+  r16 &operator=(const r16 &) = delete; // would rebind the view, not copy the value
 
-  [[nodiscard]] r8 lo() const noexcept;
-  [[nodiscard]] r8 hi() const noexcept;
+  r16 &operator=(const n16 nn) noexcept {
+    assign(nn.m_data);
+    return *this;
+  }
 
-  [[nodiscard]] std::uint16_t data() const noexcept;
-  [[nodiscard]] byte operator*() const noexcept;
+  [[nodiscard]] r8 lo() const noexcept {
+    return std::bit_cast<r8>(m_lo[0]);
+  }
 
-  r16 &operator++() noexcept;
-  r16 &operator--() noexcept;
+  [[nodiscard]] r8 hi() const noexcept {
+    return std::bit_cast<r8>(m_lo[1]);
+  }
 
-  r16 &operator+=(const r16 rr) noexcept;
-  r16 &operator-=(const r16 rr) noexcept;
+  [[nodiscard]] std::uint16_t data() const noexcept {
+    return std::uint16_t(m_lo[1] << 8 | m_lo[0]);
+  }
+
+  r16 &operator++() noexcept {
+    assign(data() + 1);
+    return *this;
+  }
 
-  r16 &operator+=(const n16 nn) noexcept;
-  r16 &operator-=(const n16 nn) noexcept;
+  r16 &operator--() noexcept {
+    assign(data() - 1);
+    return *this;
+  }
+
+  r16 &operator+=(const r16 rr) noexcept {
+    assign(data() + rr.data());
+    return *this;
+  }
+
+  r16 &operator-=(const r16 rr) noexcept {
+    assign(data() - rr.data());
+    return *this;
+  }
+
+  r16 &operator+=(const n16 nn) noexcept {
+    assign(data() + nn.m_data);
+    return *this;
+  }
+
+  r16 &operator-=(const n16 nn) noexcept {
+    assign(data() - nn.m_data);
+    return *this;
+  }
 
   auto operator<=>(const r16 rr) const noexcept {
     return data() <=> rr.data();
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <LR35902/config.h>
+#include <LR35902/cpu/immediate/n16.h>
+#include <LR35902/cpu/registers/flags.h>
+#include <LR35902/cpu/registers/r8.h>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace LR35902 {
+
+// The programmer visible state of the CPU in 16 bytes, no padding and no pointers, so it can be copied around with
+// memcpy, e.g. to snapshot a machine. The registers making up a pair are next to each other, low one first, see r16.
+struct register_file {
+  n16 SP; // stack pointer
+  n16 PC; // program counter
+
+  r8 C, B;
+  r8 E, D;
+  r8 L, H;
+  r8 A;
+  flags F;
+
+  flag ime{}; // interrupt master enable
+
+  bool operator==(const register_file &) const = default;
+};
+
+static_assert(std::is_trivially_copyable_v<register_file>);
+static_assert(std::is_standard_layout_v<register_file>);
+static_assert(sizeof(register_file) == 16);
+
+static_assert(offsetof(register_file, B) == offsetof(register_file, C) + 1);
+static_assert(offsetof(register_file, D) == offsetof(register_file, E) + 1);
+static_assert(offsetof(register_file, H) == offsetof(register_file, L) + 1);
+
+} // namespace LR35902
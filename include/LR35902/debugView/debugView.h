@@ -6,8 +6,10 @@
 #include <imgui.h>
 #include <imgui_memory_editor.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <map>
+#include <optional>
 
 class Emu;
 
@@ -18,6 +20,7 @@ class DebugView {
   const Emu &emu;
 
   MemoryEditor memory_editor;
+  std::optional<std::size_t> m_edited; // the offset of the last byte written from the memory editor, if any
 
 public:
   bool _memory_portions = true;
@@ -6,18 +6,17 @@
 
 namespace LR35902 {
 
-class IO;
+struct State;
 
 class Interrupt {
 public:
   enum class kind : std::uint8_t { vblank, lcd_stat, timer, serial, joypad };
 
 private:
-  IO &m_io;
-  byte _IE{};
+  State &m_state;
 
 public:
-  explicit Interrupt(IO &io);
+  explicit Interrupt(State &state);
 
   [[nodiscard]] bool isThereAnAwaitingInterrupt() const noexcept;
 
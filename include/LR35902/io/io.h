@@ -2,111 +2,121 @@
 #include <LR35902/config.h>
 
 #include <array>
+#include <cstddef>
+#include <type_traits>
 
 namespace LR35902 {
 
 // https://archive.org/details/GameBoyProgManVer1.1/page/n16/mode/1up
+//
+// The registers laid out as they are mapped from 0xff00 on, the unnamed ones fill the gaps. Nothing but bytes, so the
+// whole of it can be copied, compared, or indexed as the memory it is.
 class IO {
-  std::array<byte, 127_B> m_data{};
-
 public:
-  IO() = default;
   // joypad
-  byte &P1 = m_data[0x00];
+  byte P1{}; // 0x00
 
   // serial cable
-  byte &SB = m_data[0x01];
-  byte &SC = m_data[0x02];
+  byte SB{};
+  byte SC{};
+  byte _03{};
 
   // timer registers
-  byte &DIV = m_data[0x04];
-  byte &TIMA = m_data[0x05];
-  byte &TMA = m_data[0x06];
-  byte &TAC = m_data[0x07];
+  byte DIV{}; // 0x04
+  byte TIMA{};
+  byte TMA{};
+  byte TAC{};
+  std::array<byte, 7> _08{};
 
-  // sound registers
-  byte &NR10 = m_data[0x10];
-  byte &NR11 = m_data[0x11];
-  byte &NR12 = m_data[0x12];
-  byte &NR13 = m_data[0x13];
-  byte &NR14 = m_data[0x14];
-
-  byte &NR21 = m_data[0x16];
-  byte &NR22 = m_data[0x17];
-  byte &NR23 = m_data[0x18];
-  byte &NR24 = m_data[0x19];
-
-  byte &NR30 = m_data[0x1A];
-  byte &NR31 = m_data[0x1B];
-  byte &NR32 = m_data[0x1C];
-  byte &NR33 = m_data[0x1D];
-  byte &NR34 = m_data[0x1E];
-
-  byte &NR41 = m_data[0x20];
-  byte &NR42 = m_data[0x21];
-  byte &NR43 = m_data[0x22];
-  byte &NR44 = m_data[0x23];
-  byte &NR50 = m_data[0x24];
-  byte &NR51 = m_data[0x25];
-  byte &NR52 = m_data[0x26];
-
-#if defined(CGB)
-  // infrared (CGB only)
-  byte &KEY1 = m_data[0x4d];
-  byte &RP = m_data[0x56];
-
-  // bank registers (CGB only)
-  byte &VBK = m_data[0x4f];
-  byte &SVBK = m_data[0x70];
-#endif
   // interrupt registers
-  byte &IF = m_data[0x0f]; // interrupt request
+  byte IF{}; // 0x0f, interrupt request
+
+  // sound registers
+  byte NR10{}; // 0x10
+  byte NR11{};
+  byte NR12{};
+  byte NR13{};
+  byte NR14{};
+  byte _15{};
+
+  byte NR21{}; // 0x16
+  byte NR22{};
+  byte NR23{};
+  byte NR24{};
+
+  byte NR30{}; // 0x1a
+  byte NR31{};
+  byte NR32{};
+  byte NR33{};
+  byte NR34{};
+  byte _1f{};
+
+  byte NR41{}; // 0x20
+  byte NR42{};
+  byte NR43{};
+  byte NR44{};
+  byte NR50{};
+  byte NR51{};
+  byte NR52{};
+  std::array<byte, 25> _27{}; // along with the wave pattern RAM
 
   // LCD registers
-  byte &LCDC = m_data[0x40];
-  byte &STAT = m_data[0x41];
+  byte LCDC{}; // 0x40
+  byte STAT{};
 
-  byte &SCY = m_data[0x42];
-  byte &SCX = m_data[0x43];
+  byte SCY{};
+  byte SCX{};
 
-  byte &LY = m_data[0x44];
-  byte &LYC = m_data[0x45];
+  byte LY{}; // 0x44
+  byte LYC{};
 
-  byte &DMA = m_data[0x46];
+  byte DMA{}; // 0x46
 
-  byte &BGP = m_data[0x47];
-  byte &OBP0 = m_data[0x48];
-  byte &OBP1 = m_data[0x49];
+  byte BGP{}; // 0x47
+  byte OBP0{};
+  byte OBP1{};
 
-  byte &WY = m_data[0x4a];
-  byte &WX = m_data[0x4b];
+  byte WY{}; // 0x4a
+  byte WX{};
+  byte _4c{};
 
-#if defined(CGB)
-  // DMA (CGB only)
-  byte &HDMA1 = m_data[0x51];
-  byte &HDMA2 = m_data[0x52];
-  byte &HDMA3 = m_data[0x53];
-  byte &HDMA4 = m_data[0x54];
-  byte &HDMA5 = m_data[0x55];
+  // infrared and bank registers, DMA, palettes (CGB only)
+  byte KEY1{}; // 0x4d
+  byte _4e{};
+  byte VBK{};
+  byte _50{}; // the boot ROM switch, handled by the bus
 
-  // Palettes (CBG only)
-  byte &BCPS = m_data[0x68];
-  byte &BCPD = m_data[0x69];
-  byte &OCPS = m_data[0x6a];
-  byte &OCPD = m_data[0x6b];
-#endif
+  byte HDMA1{}; // 0x51
+  byte HDMA2{};
+  byte HDMA3{};
+  byte HDMA4{};
+  byte HDMA5{};
+  byte RP{}; // 0x56
+  std::array<byte, 17> _57{};
 
-  IO &get() noexcept {
-    return *this;
-  }
+  byte BCPS{}; // 0x68
+  byte BCPD{};
+  byte OCPS{};
+  byte OCPD{};
+  std::array<byte, 4> _6c{};
+
+  byte SVBK{}; // 0x70
+  std::array<byte, 14> _71{};
+
+  static constexpr std::size_t size = 127_B;
 
   [[nodiscard]] byte readIO(address_t index) const noexcept;
   void writeIO(address_t index, const byte b) noexcept;
 
-  [[nodiscard]] auto data() const noexcept -> decltype(m_data);
+  // the registers as memory, in the order they are mapped
+  [[nodiscard]] byte *data() noexcept;
+  [[nodiscard]] const byte *data() const noexcept;
   void reset() noexcept;
-
-  friend class DebugView;
 };
 
+static_assert(sizeof(IO) == IO::size);
+static_assert(std::is_trivially_copyable_v<IO> && std::is_standard_layout_v<IO>);
+static_assert(offsetof(IO, IF) == 0x0f && offsetof(IO, NR52) == 0x26 && offsetof(IO, LCDC) == 0x40);
+static_assert(offsetof(IO, WX) == 0x4b && offsetof(IO, RP) == 0x56 && offsetof(IO, SVBK) == 0x70);
+
 }
@@ -4,7 +4,7 @@
 
 namespace LR35902 {
 
-class IO;
+struct State;
 class Interrupt;
 
 // clang-format off
@@ -18,12 +18,11 @@ enum class keystatus : std::uint8_t {
 };
 
 class Joypad {
-  byte m_state{};
-  IO &m_io;
+  State &m_state;
   Interrupt &m_intr;
 
 public:
-  Joypad(IO &io, Interrupt &intr) noexcept;
+  Joypad(State &state, Interrupt &intr) noexcept;
 
   void update(button btn, keystatus status) noexcept;
   [[nodiscard]] byte read() const noexcept;
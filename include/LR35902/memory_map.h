@@ -108,5 +108,12 @@ inline constexpr address_t rom_bank_size = mmap::romx_end - mmap::romx;
 
 static_assert(sram_bank_size == 8 * 1024); // 8KiB
 static_assert(rom_bank_size == 16 * 1024); // 16 KiB
+
+// Unused upper bits of a bank register aren't wired to the chip, so bank numbers wrap around the banks present
+[[nodiscard]]
+inline std::size_t bank_offset(const std::size_t bank, const std::size_t bank_size, const std::size_t memory_size) {
+  const std::size_t bank_count = memory_size / bank_size;
+  return bank_count ? (bank % bank_count) * bank_size : 0;
+}
 }
 
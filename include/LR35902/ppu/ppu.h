@@ -1,17 +1,19 @@
 #pragma once
 
 #include <LR35902/config.h>
-
-#include <range/v3/view/chunk.hpp>
-#include <range/v3/view/subrange.hpp>
+#include <LR35902/ppu/tileline.h>
 
 #include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
 
 namespace LR35902 {
-namespace rg = ranges;
 
 class Interrupt;
-class IO;
+struct State;
 
 // clang-format off
 //
@@ -95,6 +97,8 @@ public:
   static_assert(viewport_h == 144);
 
   static constexpr std::size_t max_sprites_on_viewport_x = 10;
+  static constexpr std::size_t sprites = 40;
+  static constexpr std::size_t sprite_size = 4_B; // [y, x, tile_index, atrb]
 
   static constexpr std::size_t tileset_block_size = 4_KiB;
   static constexpr std::size_t tileset_size = 2 * tileset_block_size - 2_KiB; // -2_KiB because blocks are overlapping
@@ -108,15 +112,19 @@ public:
 
   static constexpr std::size_t tileline_size = 2_B;
   static constexpr std::size_t tile_size = tileline_size * tile_h;
+  static constexpr std::size_t tiles = tileset_size / tile_size;
+  static_assert(tiles == 384);
 
   using palette_index_t = std::uint8_t;
+  static_assert(std::is_same_v<tileline_t, std::array<palette_index_t, tile_w>>);
   using framebuffer_t = std::array<palette_index_t, viewport_h * viewport_w * 1_B>;
-  using tileset_view_t = rg::chunk_view<rg::chunk_view<rg::subrange<byte *, byte *, rg::subrange_kind::sized>>>;
-  using tilemap_view_t = rg::chunk_view<rg::subrange<byte *, byte *, rg::subrange_kind::sized>>;
-  using oam_view_t = rg::chunk_view<rg::ref_view<std::array<byte, 160_B>>>;
 
 public:
-  PPU(Interrupt &intr, IO &io) noexcept;
+  PPU(Interrupt &intr, State &state) noexcept;
+
+  // Takes over the frames another machine's PPU drew. VRAM, OAM and the registers come along with the State.
+  PPU(const PPU &) = delete;
+  PPU &operator=(const PPU &other) noexcept;
 
   [[nodiscard]] byte readVRAM(address_t index) const noexcept;
   void writeVRAM(address_t index, const byte b) noexcept;
@@ -126,6 +134,9 @@ public:
 
   void update(const std::size_t cycles) noexcept;
 
+  // cycles until the next mode change, nullopt while the LCD is off
+  [[nodiscard]] std::optional<std::size_t> nextEvent() const noexcept;
+
   [[nodiscard]] auto getFrameBuffer() noexcept -> const framebuffer_t &;
 
 #if defined(WITH_DEBUGGER)
@@ -146,11 +157,8 @@ public:
   [[nodiscard]] state mode() const noexcept;
 
 private:
-  std::array<byte, 8_KiB> m_vram{};
-  std::array<byte, 160_B> m_oam{};
-
   Interrupt &intr;
-  IO &io;
+  State &m_state; // VRAM, OAM, the registers, and the cycles into the current mode
 
   /// lcd controller
   [[nodiscard]] bool isLCDEnabled() const noexcept;
@@ -176,14 +184,16 @@ private:
   void resetScanline() noexcept;
   bool checkCoincidence() const noexcept;
 
-  /// palettes
-  std::array<palette_index_t, 4> bgp() const noexcept;
-  std::array<palette_index_t, 4> obp0() const noexcept;
-  std::array<palette_index_t, 4> obp1() const noexcept;
-
-  std::unordered_map<std::uint16_t, std::array<palette_index_t, tile_w>> tileline_cache;
+  /// palettes, what each index of a tile line is shown as
+  struct palette_t {
+    byte reg{}; // the register it was made from, all indices map to 0 for 0
+    std::array<palette_index_t, 4> colors{};
+  };
+  palette_t m_bgp;
+  palette_t m_obp0;
+  palette_t m_obp1;
 
-  std::array<palette_index_t, tile_w> decodeTilelinePaletteIndices(byte tileline_byte_lower, byte tileline_byte_upper);
+  void updatePalettes() noexcept;
 
   /// window y, x
   int window_y() const noexcept;
@@ -200,17 +210,36 @@ private:
 #endif
   framebuffer_t m_framebuffer{};
 
-  tileset_view_t tileset_view;
-  tilemap_view_t tilemap_view;
-  oam_view_t oam_view;
+  // Which sprites are on each line by their y, a bit for each in OAM order, for sprites 8 and 16 lines tall. Kept up to
+  // date by writeOAM, the DMA included as it writes through it, so a line finds its sprites with a single load.
+  std::array<std::array<std::uint64_t, viewport_h>, 2> m_sprites_on_line{};
+  static_assert(sprites <= 64);
+
+  void indexSprite(std::size_t sprite, bool on) noexcept;
+  void indexSprites() noexcept;
+
+  /// the tile set, each tile decoded once after its 16 bytes changed, on its first use
+  struct decoded_tile_t {
+    std::array<tileline_t, tile_h> lines;
+    std::array<tileline_t, tile_h> xflipped; // for sprites, y flipped ones are read from the bottom line up
+  };
+  std::array<decoded_tile_t, tiles> m_tiles;
+  std::bitset<tiles> m_dirty_tiles;
+#if defined(WITH_DEBUGGER)
+  std::bitset<tiles> m_changed_tiles; // since the VRAM viewer last showed them
+#endif
+
+  [[nodiscard]] const decoded_tile_t &tile(std::size_t n) noexcept;
 
-  bool is_vram_changed = true;
-  bool is_oam_changed = true;
+  // what is derived from VRAM and OAM all over again, once they changed without writeVRAM or writeOAM
+  void invalidate() noexcept;
 
-  void fetchBackground();
-  void fetchWindow();
-  void fetchSprites();
+  // a scanline at a time, straight into its 160 pixels of the framebuffer, without allocating
+  void fetchBackground() noexcept;
+  void fetchWindow() noexcept;
+  void fetchSprites() noexcept;
 
   friend class DebugView;
+  friend class SaveState;
 };
 }
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <LR35902/config.h>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace LR35902 {
+
+// A line of a tile is 2 bytes, the lower one has bit 0 of the palette index of each of the 8 pixels, the upper one bit
+// 1, the leftmost pixel in bit 7. See the tile structure in ppu.h.
+using tileline_t = std::array<std::uint8_t, 8>; // palette indices, left to right
+
+// a bit at a time, what the table is made of
+[[nodiscard]] constexpr tileline_t decodeTilelineBits(const byte lower, const byte upper) noexcept {
+  tileline_t line{};
+  for(std::uint8_t mask = 0b1000'0000; auto &index : line) {
+    const bool bit0 = lower & mask;
+    const bool bit1 = upper & mask;
+    index = (bit1 << 1) | bit0;
+    mask >>= 1;
+  }
+  return line;
+}
+
+// Every line decoded at compile time, indexed by upper << 8 | lower. Each entry is the tileline_t as it lies in memory,
+// 8 bytes in a word: 512KiB, but a lookup is a single load instead of a loop over the bits.
+extern const std::array<std::uint64_t, 0x10000> tileline_lut;
+
+[[nodiscard]] inline tileline_t decodeTileline(const byte lower, const byte upper) noexcept {
+  return std::bit_cast<tileline_t>(tileline_lut[std::size_t{upper} << 8 | lower]);
+}
+
+}
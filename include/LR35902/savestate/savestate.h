@@ -0,0 +1,135 @@
+#pragma once
+
+#include <LR35902/config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace LR35902 {
+
+class Bus;
+class CPU;
+class Cartridge;
+class PPU;
+class Scheduler;
+struct State;
+
+// The complete state of a machine as a flat sequence of bytes: a header, then every component's fields stored raw, in
+// the host's byte order, one after the other. What can be derived (the page table of the Bus, the bank offsets of the
+// MBCs, the decoded blocks, the deadlines) isn't stored but rebuilt on load.
+//
+// The header carries the format version and identifies the ROM, a state saved by another build of the format or from
+// another ROM is refused as a whole. Nothing else is checked, a state is meant to be loaded by the program that saved
+// it. Saving into the same buffer again reuses its memory, neither saving nor loading allocates on the way.
+class SaveState {
+public:
+  static constexpr std::uint32_t magic = 0x5353'524c; // "LRSS"
+  static constexpr std::uint32_t version = 2;
+
+  struct machine {
+    CPU &cpu;
+    Scheduler &scheduler;
+    Bus &bus;
+    State &state;
+    PPU &ppu;
+    Cartridge &cart;
+  };
+
+  explicit SaveState(const machine &m) noexcept :
+      m{m} {}
+
+  // replaces the contents of out with the state
+  void save(std::vector<byte> &out);
+
+  // Returns false, leaving the machine as it was, if the state wasn't saved by this format version from the plugged ROM.
+  [[nodiscard]] bool load(std::span<const byte> in) noexcept;
+
+private:
+  machine m;
+
+  struct header_t {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t rom_size;
+    std::uint32_t rom_checksum; // the global checksum of the cartridge header
+    std::uint32_t boot_rom;     // whether the boot ROM was still mapped over the ROM
+    std::uint64_t body_size;
+  };
+  static_assert(std::has_unique_object_representations_v<header_t>); // no padding to leak into the state
+
+  // The body is walked by transfer() once for each direction, with one of these as the archive, so saving and loading
+  // can't disagree on the layout.
+  class writer {
+    std::vector<byte> &m_out;
+
+  public:
+    static constexpr bool loading = false;
+
+    explicit writer(std::vector<byte> &out) noexcept :
+        m_out{out} {}
+
+    template <typename T>
+      requires std::is_trivially_copyable_v<T>
+    void operator()(T &value) {
+      bytes({reinterpret_cast<byte *>(&value), sizeof(T)});
+    }
+
+    void bytes(const std::span<byte> b) {
+      m_out.insert(m_out.end(), b.begin(), b.end());
+    }
+  };
+
+  // measures what a writer would write
+  class counter {
+    std::size_t m_size{};
+
+  public:
+    static constexpr bool loading = false;
+
+    template <typename T>
+      requires std::is_trivially_copyable_v<T>
+    void operator()(T &) noexcept {
+      m_size += sizeof(T);
+    }
+
+    void bytes(const std::span<byte> b) noexcept {
+      m_size += b.size();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+      return m_size;
+    }
+  };
+
+  class reader {
+    std::span<const byte> m_in;
+
+  public:
+    static constexpr bool loading = true;
+
+    explicit reader(const std::span<const byte> in) noexcept :
+        m_in{in} {}
+
+    template <typename T>
+      requires std::is_trivially_copyable_v<T>
+    void operator()(T &value) noexcept {
+      bytes({reinterpret_cast<byte *>(&value), sizeof(T)});
+    }
+
+    void bytes(const std::span<byte> b) noexcept {
+      std::memcpy(b.data(), m_in.data(), b.size()); // the size checked against the header beforehand
+      m_in = m_in.subspan(b.size());
+    }
+  };
+
+  [[nodiscard]] header_t header() const noexcept;
+
+  template <typename Archive>
+  void transfer(Archive &a);
+};
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace LR35902 {
+
+class Clock;
+class PPU;
+class Timer;
+struct State;
+
+// Keeps the absolute cycle at which each component next has something to do (a PPU mode change, a timer overflow)
+// and sets the deadline of the clock to the earliest of them. The CPU runs uninterrupted until then, the components
+// catch up with all the cycles at once in sync(). The bus syncs too before an access to memory or a register whose
+// contents depend on how far they got (VRAM, OAM, LCD and timer registers, IF).
+class Scheduler {
+public:
+  enum class event : std::uint8_t { ppu, timer };
+  static constexpr std::size_t event_count = 2;
+
+  // the longest the CPU runs without a sync, one frame, when no component has anything scheduled
+  static constexpr std::uint64_t max_slice = 17'556;
+
+private:
+  State &m_state; // the cycle the components caught up to is in it
+  Clock &m_clock;
+  PPU &m_ppu;
+  Timer &m_timer;
+
+  std::array<std::optional<std::uint64_t>, event_count> m_deadlines{};
+  std::optional<std::uint64_t> m_limit; // see limit()
+
+public:
+  Scheduler(State &state, Clock &clock, PPU &ppu, Timer &timer) noexcept;
+
+  // at is an absolute cycle, nullopt cancels the event
+  void schedule(const event e, const std::optional<std::uint64_t> at) noexcept;
+
+  // No deadline is set past at, however the components reschedule, until nullopt lifts the limit. E.g. to run for a
+  // given number of cycles.
+  void limit(const std::optional<std::uint64_t> at) noexcept;
+
+  // the earliest deadline, at most max_slice cycles after the last sync and never past the limit
+  [[nodiscard]] std::uint64_t next() const noexcept;
+
+  // brings the components up to the clock, then reschedules them
+  void sync() noexcept;
+
+  // asks the components for their next events again, e.g. after a write to one of their registers
+  void reschedule() noexcept;
+
+};
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <LR35902/builtin/builtin.h>
+#include <LR35902/cartridge/kind/mbc_registers.h>
+#include <LR35902/config.h>
+#include <LR35902/cpu/registers/register_file.h>
+#include <LR35902/io/io.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace LR35902 {
+
+// The mutable memory of a machine and the counters its components keep, in one block. The components work on their
+// part of it in place, so the hot data sits together and a snapshot of it is a memcpy, comparing two is a memcmp.
+struct state_fields {
+  register_file registers; // of the CPU
+
+  std::uint64_t cycles{}; // machine cycles since power on, see Clock
+  std::uint64_t latest{}; // the cycles of the latest step of the clock
+  std::uint64_t deadline = std::numeric_limits<std::uint64_t>::max(); // the CPU stops once cycles reaches it
+  std::uint64_t synced{};        // the cycle the components caught up to, see Scheduler
+  std::uint64_t timer_counter{}; // the machine cycles the timer has seen, TIMA counts the falling edges of its bits
+  std::uint64_t ppu_cycles{};    // into the current mode of the PPU
+  std::uint32_t div_counter{};   // cycles towards the next increment of DIV
+
+  byte IE{};      // the interrupts enabled, at 0xffff
+  byte buttons{}; // a bit a button, 0 when it is pressed; P1 selects which half of them is read
+
+  mbc_registers mbc{}; // the bank registers of the cartridge, whatever its kind
+
+  IO io;
+  BuiltIn builtIn; // WRAM, HRAM and the rest on the board
+
+  std::array<byte, 8_KiB> vram{};
+  std::array<byte, 160_B> oam{};
+};
+
+// up to the next cache line, so that there are no padding bytes for a memcmp to trip on
+template <std::size_t N>
+struct state_padding {
+  std::array<byte, N> unused{};
+};
+
+template <>
+struct state_padding<0> {};
+
+// It holds no pointers and has no padding. What the components derive from it (the page table of the bus, the
+// decoded blocks, the mapping of the banks) is rebuilt from it, the contents of the cartridge and the framebuffer stay
+// with their owners.
+struct alignas(64) State : state_fields, state_padding<(64 - sizeof(state_fields) % 64) % 64> {};
+
+static_assert(std::is_trivially_copyable_v<State>);
+static_assert(std::has_unique_object_representations_v<State>);
+static_assert(sizeof(State) % 64 == 0);
+
+}
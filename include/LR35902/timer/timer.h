@@ -2,23 +2,25 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 
 namespace LR35902 {
 
-class IO;
+struct State;
 class Interrupt;
 
 class Timer {
-  IO &m_io;
+  State &m_state;
   Interrupt &m_intr;
 
-  std::uint16_t counter = 0;
-  std::uint16_t previous_counter = 0;
-  std::uint16_t div_counter = 0;
-
 public:
-  Timer(IO &io, Interrupt &intr);
+  Timer(State &state, Interrupt &intr);
+
+  // catches up with any number of cycles at once
   void update(const std::size_t cycles) noexcept;
+
+  // cycles until TIMA overflows, nullopt while the timer is off
+  [[nodiscard]] std::optional<std::size_t> nextEvent() const noexcept;
 };
 
 }
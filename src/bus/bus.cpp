@@ -8,28 +8,44 @@
 #include <LR35902/joypad/joypad.h>
 #include <LR35902/memory_map.h>
 #include <LR35902/ppu/ppu.h>
+#include <LR35902/scheduler/scheduler.h>
 
 #include <mpark/patterns/match.hpp>
 #include <mpark/patterns/when.hpp>
 
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <optional>
 
 namespace LR35902 {
 
-Bus::Bus(Cartridge &cart, PPU &ppu, BuiltIn &builtIn, DMA &dma, IO &io, Interrupt &interrupt, Joypad &joypad) :
+Bus::Bus(Cartridge &cart, PPU &ppu, BuiltIn &builtIn, DMA &dma, IO &io, Interrupt &interrupt, Joypad &joypad,
+         Scheduler &scheduler) :
     m_cart{cart},
     m_ppu{ppu},
     m_builtIn{builtIn},
     m_dma{dma},
     m_io{io},
     m_joypad(joypad),
-    interruptHandler{interrupt} {}
+    m_scheduler{scheduler},
+    interruptHandler{interrupt} {
+  remap();
+}
+
+// what the PPU and the timer change as the cycles pass: VRAM and OAM (locked by the PPU mode), the timer registers, IF
+// and the LCD registers
+[[nodiscard]] constexpr bool isTimed(const address_t index) noexcept {
+  return (index >= mmap::vram && index < mmap::vram_end) || (index >= mmap::oam && index < mmap::oam_end) ||
+         (index >= 0xff04 && index <= 0xff07) || index == 0xff0f || (index >= 0xff40 && index <= 0xff4b);
+}
 
 // clang-format off
-byte Bus::read(const address_t index) const noexcept {
+byte Bus::readSlow(const address_t index) const noexcept {
   using namespace mpark::patterns;
 
+  if(isTimed(index)) m_scheduler.sync();
+
   return match(index)(
       pattern(arg).when(arg >= mmap::rom0 && arg < mmap::romx_end) = [&] (auto index) { return m_cart.readROM(index); },
       pattern(arg).when(arg >= mmap::vram && arg < mmap::vram_end) = [&] (auto index) { return m_ppu.readVRAM(index); },
@@ -44,11 +60,21 @@ byte Bus::read(const address_t index) const noexcept {
       );
 }
 
-void Bus::write(const address_t index, const byte b) noexcept {
+void Bus::writeSlow(const address_t index, const byte b) noexcept {
   using namespace mpark::patterns;
 
+  if(byte *const page = m_ram[index / page_size]) { // write protected, see protect()
+    m_writable[index / page_size] = page;
+    invalidate(index);
+    page[index % page_size] = b;
+    return;
+  }
+
+  const bool timed = isTimed(index);
+  if(timed) m_scheduler.sync();
+
   match(index)(
-      pattern(arg).when(arg >= mmap::rom0 && arg < mmap::romx_end) = [&] (auto index) { m_cart.writeROM(index, b); },
+      pattern(arg).when(arg >= mmap::rom0 && arg < mmap::romx_end) = [&] (auto index) { m_cart.writeROM(index, b); invalidate(index); mapCartridge(); },
       pattern(arg).when(arg >= mmap::vram && arg < mmap::vram_end) = [&] (auto index) { m_ppu.writeVRAM(index, b); },
       pattern(arg).when(arg >= mmap::sram && arg < mmap::sram_end) = [&] (auto index) { m_cart.writeSRAM(index, b); },
       pattern(arg).when(arg >= mmap::wram0 && arg < mmap::wramx_end) = [&] (auto index) { m_builtIn.writeWRAM(index, b); },
@@ -58,10 +84,75 @@ void Bus::write(const address_t index, const byte b) noexcept {
       pattern(arg).when(arg >= mmap::io && arg < mmap::io_end) = [&] (auto index) {
           match(index)(
                 pattern(0xff46) = [&] { m_dma.action(b); }, //
-                pattern(0xff50) = [&] { m_cart.unmapBootROM(); }, //
+                pattern(0xff50) = [&] { m_cart.unmapBootROM(); invalidate(mmap::bootrom_start); mapCartridge(); }, //
                 pattern(_) = [&] { m_io.writeIO(index, b); }); },
       pattern(arg).when(arg >= mmap::hram && arg < mmap::hram_end) = [&] (auto index){ m_builtIn.writeHRAM(index, b); },
       pattern(mmap::IE) = [&] { interruptHandler.IE(b); });
+
+  if(timed && index >= mmap::io) m_scheduler.reschedule(); // e.g. the timer or the LCD got turned on
+}
+// clang-format on
+
+void Bus::mapCartridge() noexcept {
+  constexpr std::size_t pages_per_bank = rom_bank_size / page_size;
+
+  const byte *const rom0 = m_cart.size() >= rom_bank_size ? m_cart.data() : nullptr;
+  const byte *const romx = m_cart.ROMXData(); // bank switching on MBC register writes ends up here
+
+  for(std::size_t page = 0; page < pages_per_bank; ++page) {
+    m_readable[mmap::rom0 / page_size + page] = rom0 ? rom0 + page * page_size : nullptr;
+    m_readable[mmap::romx / page_size + page] = romx ? romx + page * page_size : nullptr;
+  }
+
+  // the boot ROM is a page over the ROM, until it hands over
+  static_assert(mmap::bootrom_end - mmap::bootrom_start == page_size);
+  if(const byte *const boot = m_cart.bootROMData()) m_readable[mmap::bootrom_start / page_size] = boot;
+
+  // The RAM is accessed directly while it's enabled and plain memory, the MBC sees the rest. It may hold code: the
+  // pages get new versions, as the bank under them may have changed, and can be protected like the rest of the RAM.
+  byte *const sramx = m_cart.SRAMXData();
+  for(std::size_t page = mmap::sram / page_size; page < mmap::sram_end / page_size; ++page) {
+    byte *const p = sramx ? sramx + (page * page_size - mmap::sram) : nullptr;
+    m_readable[page] = p;
+    m_writable[page] = p;
+    m_ram[page] = p;
+    ++m_version[page];
+  }
+}
+
+std::optional<std::size_t> Bus::romOffset(const address_t index) const noexcept {
+  const byte *const page = m_readable[index / page_size];
+  if(!page) return std::nullopt;
+
+  const auto begin = reinterpret_cast<std::uintptr_t>(m_cart.data());
+  const auto at = reinterpret_cast<std::uintptr_t>(page);
+  if(at < begin || at >= begin + m_cart.size()) return std::nullopt;
+
+  return at - begin + index % page_size;
+}
+
+void Bus::remap() noexcept {
+  m_readable.fill(nullptr);
+  m_writable.fill(nullptr);
+  m_ram.fill(nullptr);
+
+  for(auto &version : m_version)
+    ++version;
+  ++m_epoch;
+
+  mapCartridge();
+
+  const auto mapRAM = [&](const address_t begin, const address_t end, byte *const memory) {
+    for(std::size_t page = begin / page_size; page < end / page_size; ++page) {
+      byte *const p = memory + (page * page_size - begin);
+      m_readable[page] = p;
+      m_writable[page] = p;
+      m_ram[page] = p;
+    }
+  };
+
+  mapRAM(mmap::wram0, mmap::wramx_end, m_builtIn.m_wram.data());
+  mapRAM(mmap::echo, mmap::echo_end, m_builtIn.m_echo.data());
 }
 
 // https://gbdev.io/pandocs/Power_Up_Sequence.html#hardware-registers
@@ -4,8 +4,8 @@
 #include <LR35902/cartridge/kind/mbc_config.h>
 #include <LR35902/config.h>
 #include <LR35902/memory_map.h>
+#include <LR35902/state/state.h>
 
-#include <range/v3/algorithm/swap_ranges.hpp>
 #include <range/v3/range/conversion.hpp>
 #include <range/v3/view/filter.hpp>
 
@@ -31,6 +31,19 @@ namespace rg = ranges;
 namespace rv = rg::views;
 namespace fs = std::filesystem;
 
+Cartridge::Cartridge(State &state) noexcept :
+    m_state{state} {}
+
+Cartridge &Cartridge::operator=(const Cartridge &other) {
+  header = other.header;
+  m_cart = other.m_cart;
+  m_open_bus = other.m_open_bus;
+  is_bootROM_successfully_loaded = other.is_bootROM_successfully_loaded;
+  is_bootROM_mapped = other.is_bootROM_mapped;
+  bootrom_buf = other.bootrom_buf;
+  return *this;
+}
+
 bool Cartridge::loadBootROM() noexcept {
   constexpr std::array<std::string_view, 4> possibleBootROMFileNames{"bootrom.gb", "bootrom.bin", "dmg_boot.bin",
                                                                      "dmg0_boot.bin"};
@@ -56,48 +69,45 @@ bool Cartridge::loadBootROM() noexcept {
   bootrom_buf.resize(bootrom_size);
   bootrom_buf.shrink_to_fit();
   this->is_bootROM_successfully_loaded = true;
+  this->is_bootROM_mapped = true;
 
   return true;
 }
 
 bool Cartridge::loadROM(const char *const romfile) noexcept {
-  std::ifstream fin{romfile, std::ios::binary};
-  if(!fin) return false;
-
-  dumpedGamePak = std::vector<byte>(std::istreambuf_iterator<char>{fin}, {});
-  if(std::size(dumpedGamePak) == 0) return false;
+  const rom_t rom = rom_image::open(romfile);
+  if(!rom || rom->size() < mmap::header_end) return false;
 
-  if(is_bootROM_successfully_loaded) mapBootROM();
-
-  std::vector<byte> chunkThatContainHeaderData(dumpedGamePak.begin(), dumpedGamePak.begin() + mmap::header_end);
+  std::vector<byte> chunkThatContainHeaderData(rom->data(), rom->data() + mmap::header_end);
   this->header.assign(std::move(chunkThatContainHeaderData));
 
   if(!header.is_logocheck_ok()) return false;
 
   const auto SRAM_size = header.decode_ram_size().second;
   const auto MBC_type = header.decode_mbc_type().second;
+  mbc_registers &r = m_state.mbc;
   using namespace mp;
   match(MBC_type)(
-      pattern(0x00) = [&] { m_cart = rom_only(dumpedGamePak); }, pattern(0x01) = [&] { m_cart = mbc1(dumpedGamePak, {}); },
-      pattern(0x02) = [&] { m_cart = mbc1(dumpedGamePak, {.sram_size = SRAM_size}); },
-      pattern(0x03) = [&] { m_cart = mbc1(dumpedGamePak, {.sram_size = SRAM_size, .has_battery = true}); },
-      pattern(0x05) = [&] { m_cart = mbc2(dumpedGamePak, {}); },
-      pattern(0x06) = [&] { m_cart = mbc2(dumpedGamePak, {.has_battery = true}); },
-      pattern(0x08) = [&] { m_cart = rom_ram(dumpedGamePak, {}); },
-      pattern(0x09) = [&] { m_cart = rom_ram(dumpedGamePak, {.has_battery = true}); },
-      pattern(0x0f) = [&] { m_cart = mbc3(dumpedGamePak, {.has_timer = true, .has_battery = true}); },
+      pattern(0x00) = [&] { m_cart = rom_only(rom); }, pattern(0x01) = [&] { m_cart = mbc1(rom, {}, r); },
+      pattern(0x02) = [&] { m_cart = mbc1(rom, {.sram_size = SRAM_size}, r); },
+      pattern(0x03) = [&] { m_cart = mbc1(rom, {.sram_size = SRAM_size, .has_battery = true}, r); },
+      pattern(0x05) = [&] { m_cart = mbc2(rom, {}, r); },
+      pattern(0x06) = [&] { m_cart = mbc2(rom, {.has_battery = true}, r); },
+      pattern(0x08) = [&] { m_cart = rom_ram(rom, {}); },
+      pattern(0x09) = [&] { m_cart = rom_ram(rom, {.has_battery = true}); },
+      pattern(0x0f) = [&] { m_cart = mbc3(rom, {.has_timer = true, .has_battery = true}, r); },
       pattern(0x10) =
-          [&] { m_cart = mbc3(dumpedGamePak, {.sram_size = SRAM_size, .has_timer = true, .has_battery = true}); },
-      pattern(0x11) = [&] { m_cart = mbc3(dumpedGamePak, {}); },
-      pattern(0x12) = [&] { m_cart = mbc3(dumpedGamePak, {.sram_size = SRAM_size}); },
-      pattern(0x13) = [&] { m_cart = mbc3(dumpedGamePak, {.sram_size = SRAM_size, .has_battery = true}); },
-      pattern(0x19) = [&] { m_cart = mbc5(dumpedGamePak, {}); },
-      pattern(0x1a) = [&] { m_cart = mbc5(dumpedGamePak, {.sram_size = SRAM_size}); },
-      pattern(0x1b) = [&] { m_cart = mbc5(dumpedGamePak, {.sram_size = SRAM_size, .has_battery = true}); },
-      pattern(0x1c) = [&] { m_cart = mbc5(dumpedGamePak, {.has_rumble = true}); },
-      pattern(0x1d) = [&] { m_cart = mbc5(dumpedGamePak, {.sram_size = SRAM_size, .has_rumble = true}); },
+          [&] { m_cart = mbc3(rom, {.sram_size = SRAM_size, .has_timer = true, .has_battery = true}, r); },
+      pattern(0x11) = [&] { m_cart = mbc3(rom, {}, r); },
+      pattern(0x12) = [&] { m_cart = mbc3(rom, {.sram_size = SRAM_size}, r); },
+      pattern(0x13) = [&] { m_cart = mbc3(rom, {.sram_size = SRAM_size, .has_battery = true}, r); },
+      pattern(0x19) = [&] { m_cart = mbc5(rom, {}, r); },
+      pattern(0x1a) = [&] { m_cart = mbc5(rom, {.sram_size = SRAM_size}, r); },
+      pattern(0x1b) = [&] { m_cart = mbc5(rom, {.sram_size = SRAM_size, .has_battery = true}, r); },
+      pattern(0x1c) = [&] { m_cart = mbc5(rom, {.has_rumble = true}, r); },
+      pattern(0x1d) = [&] { m_cart = mbc5(rom, {.sram_size = SRAM_size, .has_rumble = true}, r); },
       pattern(0x1e) =
-          [&] { m_cart = mbc5(dumpedGamePak, {.sram_size = SRAM_size, .has_battery = true, .has_rumble = true}); },
+          [&] { m_cart = mbc5(rom, {.sram_size = SRAM_size, .has_battery = true, .has_rumble = true}, r); },
       pattern(_) =
           [&] {
             const std::string msg =                       //
@@ -110,16 +120,12 @@ bool Cartridge::loadROM(const char *const romfile) noexcept {
   return true;
 }
 
-void Cartridge::mapBootROM() noexcept {
-  rg::swap_ranges(bootrom_buf, dumpedGamePak);
+void Cartridge::unmapBootROM() noexcept {
+  is_bootROM_mapped = false;
 }
 
-void Cartridge::unmapBootROM() noexcept {
-  if(is_bootROM_successfully_loaded) {
-    std::visit([&](auto &cart) { rg::swap_ranges(bootrom_buf, cart.m_rom); }, m_cart);
-    bootrom_buf.resize(0);
-    bootrom_buf.shrink_to_fit();
-  }
+const byte *Cartridge::bootROMData() const noexcept {
+  return is_bootROM_mapped ? bootrom_buf.data() : nullptr;
 }
 
 // clang-format off
@@ -127,23 +133,24 @@ template <typename... Ts> struct overloaded : Ts... { using Ts::operator()...; }
 template <typename... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 
 byte Cartridge::readROM(const address_t index) const noexcept {
+  if(is_bootROM_mapped && index < mmap::bootrom_end) return bootrom_buf[index];
   return std::visit([&](const auto &cart) { return cart.readROM(index); }, m_cart);
 }
 
 void Cartridge::writeROM(const address_t index, const byte b) noexcept {
-    std::visit([&](auto &cart) { return cart.writeROM(index, b); }, m_cart);
+    std::visit([&](auto &cart) { return cart.writeROM(m_state.mbc, index, b); }, m_cart);
 }
 
 byte Cartridge::readSRAM(const address_t index) const noexcept {
   return std::visit(overloaded {
-                                 [&](const auto &cart)  { return cart.readSRAM(index); },
-                                 [&](const rom_only &) { return random_byte();       },
+                                 [&](const auto &cart)  { return cart.readSRAM(m_state.mbc, index); },
+                                 [&](const rom_only &) { return m_open_bus.read();    },
                                }, m_cart);
 }
 
 void Cartridge::writeSRAM(const address_t index, const byte b) noexcept {
   std::visit(overloaded {
-                          [&](auto &cart)  { cart.writeSRAM(index, b); },
+                          [&](auto &cart)  { cart.writeSRAM(m_state.mbc, index, b); },
                           [&](rom_only &) {    /* do nothing */      },
                         }, m_cart);
 }
@@ -156,11 +163,23 @@ void Cartridge::reset() noexcept { // only resets SRAM
 }
 
 const byte *Cartridge::data() const noexcept {
-  return std::visit([&](const auto &cart) { return cart.m_rom.data(); }, m_cart);
+  return std::visit([&](const auto &cart) { return cart.m_rom->data(); }, m_cart);
 }
 
 std::size_t Cartridge::size() const noexcept {
-  return std::visit([&](const auto &cart) { return cart.m_rom.size(); }, m_cart);
+  return std::visit([&](const auto &cart) { return cart.m_rom->size(); }, m_cart);
+}
+
+const byte *Cartridge::ROMXData() const noexcept {
+  return std::visit([&](const auto &cart) { return cart.romxData(); }, m_cart);
+}
+
+byte *Cartridge::SRAMXData() noexcept {
+  return std::visit(overloaded {
+                    [&](auto &cart)    { return cart.sramxData(m_state.mbc); },
+                    [&](rom_only &)    { return static_cast<byte *>(nullptr); },
+                    [&](mbc2 &)        { return static_cast<byte *>(nullptr); }, // 4 bits wide, the upper ones read back set
+                    }, m_cart);
 }
 
 std::optional<const byte *> Cartridge::SRAMData() const noexcept {
@@ -6,9 +6,6 @@
 #include <mpark/patterns/match.hpp>
 #include <mpark/patterns/when.hpp>
 
-#include <range/v3/view/chunk.hpp>
-#include <range/v3/view/const.hpp>
-
 #include <cstddef>
 
 // Verbatim implementation of:
@@ -74,62 +71,68 @@ This implies mbc1 cartridges can hold at most 16KB * 128 == 2048KB == 2MB of byt
 */
 
 namespace LR35902 {
-namespace rv = ranges::views;
 namespace mp = mpark::patterns;
 
-mbc1::mbc1(std::vector<byte> other, const MBC_config& config) :
+mbc1::mbc1(rom_t other, const MBC_config& config, mbc_registers &r) :
     m_rom{std::move(other)},
     m_sram(config.sram_size, byte{}),
     has_sram{static_cast<bool>(m_sram.size())},
-    has_battery{config.has_battery} {}
+    has_battery{config.has_battery} {
+  r = {};
+  select_banks(r);
+}
 
-// clang-format off
-byte mbc1::readROM(const address_t index) const noexcept {
-  using namespace mp;
+void mbc1::select_banks(const mbc_registers &r) noexcept {
+  const std::size_t rom_bank = (r[register_3] == 1) ? r[register_1] : ((r[register_2] << 5) | r[register_1]);
+  const std::size_t sram_bank = (r[register_3] == 1) ? r[register_2] : 0;
 
-  static const auto banked_rom_view = m_rom | rv::const_ | rv::chunk(rom_bank_size);
+  romx_offset = bank_offset(rom_bank, rom_bank_size, m_rom->size());
+  sramx_offset = bank_offset(sram_bank, sram_bank_size, m_sram.size());
+}
 
-  return match(index)(
-      pattern(_).when(_ >= mmap::rom0 && _ < mmap::romx) = [&] { return m_rom[index]; },
-      pattern(_).when(_ >= mmap::romx && _ < mmap::romx_end) = [&] {
-        const auto index_normalized = index % rom_bank_size;
-        if(register_3 == 1) return banked_rom_view[register_1][index_normalized];
-        return banked_rom_view[((register_2 << 5) | register_1)][index_normalized];
-      });
+byte mbc1::readROM(const address_t index) const noexcept {
+  if(index < mmap::romx) return (*m_rom)[index];
+  return (*m_rom)[romx_offset + normalize_index(index, mmap::romx)];
 }
 
-void mbc1::writeROM(const address_t index, const byte b) noexcept {
+void mbc1::writeROM(mbc_registers &r, const address_t index, const byte b) noexcept {
   using namespace mp;
   // clang-format off
   match(index)(
-      pattern(_).when(_ >= 0x0000 && _ < 0x2000) = [&] { register_0 = (b & 0x0f) == 0x0A; }, 
-      pattern(_).when(_ >= 0x2000 && _ < 0x4000) = [&] { register_1 = b & 0x1f; if(register_1 == 0) ++register_1; },
-      pattern(_).when(_ >= 0x4000 && _ < 0x6000) = [&] { register_2 = b & 0x3; },
-      pattern(_).when(_ >= 0x6000 && _ < 0x8000) = [&] { register_3 = b & 0x01; }
+      pattern(_).when(_ >= 0x0000 && _ < 0x2000) = [&] { r[register_0] = (b & 0x0f) == 0x0A; }, 
+      pattern(_).when(_ >= 0x2000 && _ < 0x4000) = [&] { r[register_1] = b & 0x1f; if(r[register_1] == 0) ++r[register_1]; },
+      pattern(_).when(_ >= 0x4000 && _ < 0x6000) = [&] { r[register_2] = b & 0x3; },
+      pattern(_).when(_ >= 0x6000 && _ < 0x8000) = [&] { r[register_3] = b & 0x01; }
   );
+  // clang-format on
+  select_banks(r);
 }
 
-byte mbc1::readSRAM(address_t index) const noexcept {
-  index = normalize_index(index, mmap::sram);
-  if(register_0) {
-    static const auto banked_ram_view = m_sram | rv::const_ | rv::chunk(sram_bank_size);
+const byte *mbc1::romxData() const noexcept {
+  if(romx_offset + rom_bank_size > m_rom->size()) return nullptr;
+  return m_rom->data() + romx_offset;
+}
+
+byte *mbc1::sramxData(const mbc_registers &r) noexcept {
+  if(!r[register_0] || !has_sram || sramx_offset + sram_bank_size > m_sram.size()) return nullptr;
+  return m_sram.data() + sramx_offset;
+}
 
-    if(register_3 == 1) return banked_ram_view[register_2][index];
-    else return banked_ram_view[0][index];
+byte mbc1::readSRAM(const mbc_registers &r, address_t index) const noexcept {
+  index = normalize_index(index, mmap::sram);
+  if(r[register_0] && has_sram) {
+    return m_sram[sramx_offset + index];
   }
 
   else {
-    return random_byte();
+    return m_open_bus.read();
   }
 }
 
-void mbc1::writeSRAM(address_t index, const byte b) noexcept {
+void mbc1::writeSRAM(const mbc_registers &r, address_t index, const byte b) noexcept {
   index = normalize_index(index, mmap::sram);
-  if(register_0) {
-    static const auto banked_ram_view = m_sram | rv::chunk(sram_bank_size);
-
-    if(register_3 == 1) banked_ram_view[register_2][index] = b;
-    else banked_ram_view[0][index] = b;
+  if(r[register_0] && has_sram) {
+    m_sram[sramx_offset + index] = b;
   }
 }
 
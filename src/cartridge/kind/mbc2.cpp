@@ -3,9 +3,6 @@
 #include <LR35902/cartridge/kind/mbc_config.h>
 #include <LR35902/memory_map.h>
 
-#include <range/v3/view/chunk.hpp>
-#include <range/v3/view/const.hpp>
-
 #include <cassert>
 #include <cstddef>
 
@@ -13,21 +10,25 @@
 // https://gbdev.io/pandocs/MBC2.html
 
 namespace LR35902 {
-namespace rv = ranges::views;
-
-mbc2::mbc2(std::vector<byte> rom, const MBC_config& config) :
+mbc2::mbc2(rom_t rom, const MBC_config& config, mbc_registers &r) :
     m_rom(std::move(rom)),
-    has_battery{config.has_battery} {}
+    has_battery{config.has_battery} {
+  r = {};
+  r[rom_bank] = 1;
+  select_banks(r);
+}
+
+void mbc2::select_banks(const mbc_registers &r) noexcept {
+  romx_offset = bank_offset(r[rom_bank], rom_bank_size, m_rom->size());
+}
 
 byte mbc2::readROM(const address_t index) const noexcept {
   if(index < mmap::rom0_end) {
-    return m_rom[index];
+    return (*m_rom)[index];
   }
 
   else if(index < mmap::romx_end) {
-    const std::size_t index_normalized = index % rom_bank_size;
-    static const auto banked_rom_view = m_rom | rv::const_ | rv::chunk(rom_bank_size);
-    return banked_rom_view[rom_bank][index_normalized];
+    return (*m_rom)[romx_offset + index % rom_bank_size];
   }
 
   else {
@@ -35,13 +36,14 @@ byte mbc2::readROM(const address_t index) const noexcept {
   }
 }
 
-void mbc2::writeROM(const address_t index, const byte b) noexcept {
+void mbc2::writeROM(mbc_registers &r, const address_t index, const byte b) noexcept {
   if(index < mmap::rom0_end) {
     if(index & 0b1'0000'0000) {
-      rom_bank = b & 0x0f;
-      if(rom_bank == 0) ++rom_bank;
+      r[rom_bank] = b & 0x0f;
+      if(r[rom_bank] == 0) ++r[rom_bank];
+      select_banks(r);
     } else {
-      ram_enabled = b == 0x0A;
+      r[ram_enabled] = b == 0x0A;
     }
   }
 
@@ -50,16 +52,21 @@ void mbc2::writeROM(const address_t index, const byte b) noexcept {
   }
 }
 
-byte mbc2::readSRAM(address_t index) const noexcept {
-  if(ram_enabled) {
+const byte *mbc2::romxData() const noexcept {
+  if(romx_offset + rom_bank_size > m_rom->size()) return nullptr;
+  return m_rom->data() + romx_offset;
+}
+
+byte mbc2::readSRAM(const mbc_registers &r, address_t index) const noexcept {
+  if(r[ram_enabled]) {
     index = index % 512_B;
     return m_sram[index];
   }
-  return random_byte();
+  return m_open_bus.read();
 }
 
-void mbc2::writeSRAM(address_t index, const byte b) noexcept {
-  if(ram_enabled) {
+void mbc2::writeSRAM(const mbc_registers &r, address_t index, const byte b) noexcept {
+  if(r[ram_enabled]) {
     index = index % 512_B;
     m_sram[index] = b & 0x0f;
   }
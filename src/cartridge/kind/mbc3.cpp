@@ -9,9 +9,6 @@
 #include <mpark/patterns/anyof.hpp>
 // clang-format on
 
-#include <range/v3/view/chunk.hpp>
-#include <range/v3/view/const.hpp>
-
 #include <cassert>
 #include <chrono>
 #include <cstddef>
@@ -28,7 +25,6 @@
 // https://archive.org/details/GameBoyProgManVer1.1/page/n219/mode/1up
 
 namespace LR35902 {
-namespace rv = ranges::views;
 namespace mp = mpark::patterns;
 
 void mbc3::update_RTC() noexcept {
@@ -61,66 +57,78 @@ void mbc3::update_RTC() noexcept {
   RTC.days_hi = (day_of_year_ & 0x0100) >> 8;
 }
 
-mbc3::mbc3(std::vector<byte> rom, const MBC_config &config) :
+mbc3::mbc3(rom_t rom, const MBC_config &config, mbc_registers &r) :
     m_rom(std::move(rom)),
     m_sram(config.sram_size),
     has_timer{config.has_timer},
     has_battery{config.has_battery} {
   if(has_timer) update_RTC();
   else RTC = {{}, {}, {}, {}, {}};
+  r = {};
+  r[ROM_bank] = 1;
+  select_banks(r);
+}
+
+void mbc3::select_banks(const mbc_registers &r) noexcept {
+  romx_offset = bank_offset(r[ROM_bank], rom_bank_size, m_rom->size());
+  sramx_offset = r[SRAM_bank] < 0x04 ? bank_offset(r[SRAM_bank], sram_bank_size, m_sram.size()) : 0; // 0x08-0x0C are RTC
 }
 
 // clang-format off
 byte mbc3::readROM(address_t index) const noexcept {
-  using namespace mp;
-  static const auto banked_rom_view = m_rom | rv::const_ | rv::chunk(rom_bank_size);
-
-  return match(index)(
-      pattern(_).when(_ >= 0x0000     && _ < mmap::romx) = [&] { return m_rom[index]; },
-      pattern(_).when(_ >= mmap::romx && _ < mmap::romx_end) = [&] {
-            index = normalize_index(index, mmap::romx);
-            return banked_rom_view[ROM_bank][index];
-      }
-  );
+  if(index < mmap::romx) return (*m_rom)[index];
+  return (*m_rom)[romx_offset + normalize_index(index, mmap::romx)];
 }
 
-void mbc3::writeROM(const address_t index, const byte b) noexcept {
+void mbc3::writeROM(mbc_registers &r, const address_t index, const byte b) noexcept {
   using namespace mp;
   match(index)(
-      pattern(_).when(_ >= 0x0000 && _ < 0x2000) = [&] { SRAM_enabled = b == 0x0A; },
-      pattern(_).when(_ >= 0x2000 && _ < 0x4000) = [&] { ROM_bank = b & 0x7F; if(ROM_bank == 0) ++ROM_bank; },
-      pattern(_).when(_ >= 0x4000 && _ < 0x6000) = [&] { SRAM_bank = b; },
+      pattern(_).when(_ >= 0x0000 && _ < 0x2000) = [&] { r[SRAM_enabled] = b == 0x0A; },
+      pattern(_).when(_ >= 0x2000 && _ < 0x4000) = [&] { r[ROM_bank] = b & 0x7F; if(r[ROM_bank] == 0) ++r[ROM_bank]; },
+      pattern(_).when(_ >= 0x4000 && _ < 0x6000) = [&] { r[SRAM_bank] = b; },
       pattern(_).when(_ >= 0x6000 && _ < 0x8000) = [&] {
-            latch = b;
+            r[latch] = b;
             latch_checker.push_back(b);
             is_latch_open = (latch_checker[0] == 0 && latch_checker[1] == 1);
       }
   );
+  select_banks(r);
+}
+
+const byte *mbc3::romxData() const noexcept {
+  if(romx_offset + rom_bank_size > m_rom->size()) return nullptr;
+  return m_rom->data() + romx_offset;
+}
+
+byte *mbc3::sramxData(const mbc_registers &r) noexcept {
+  if(!r[SRAM_enabled] || r[SRAM_bank] >= 0x04) return nullptr; // the RTC registers aren't memory
+  if(sramx_offset + sram_bank_size > m_sram.size()) return nullptr;
+  return m_sram.data() + sramx_offset;
 }
 
-byte mbc3::readSRAM(address_t index) const noexcept {
+byte mbc3::readSRAM(const mbc_registers &r, address_t index) const noexcept {
   using namespace mp;
   index = normalize_index(index, mmap::sram);
   const_cast<mbc3 *>(this)->update_RTC();
 
-  return match(SRAM_enabled, has_timer, is_latch_open, SRAM_bank) (
-      pattern(true, _ , _, anyof(0x00, 0x01, 0x02, 0x03)) = [&] { return m_sram[(SRAM_bank * sram_bank_size) + index]; },
+  return match(r[SRAM_enabled], has_timer, is_latch_open, r[SRAM_bank]) (
+      pattern(true, _ , _, anyof(0x00, 0x01, 0x02, 0x03)) = [&] { return m_sram[sramx_offset + index]; },
       pattern(true, true, true, 0x08) = [&] { return RTC.seconds; },
       pattern(true, true, true, 0x09) = [&] { return RTC.minutes; },
       pattern(true, true, true, 0x0A) = [&] { return RTC.hours; },
       pattern(true, true, true, 0x0B) = [&] { return RTC.days_lo; },
       pattern(true, true, true, 0x0C) = [&] { return RTC.days_hi; },
-      pattern(true, false, _, _) = [] { return random_byte(); },
-      pattern(false, _, _, _) = [] { return random_byte(); });
+      pattern(true, false, _, _) = [&] { return m_open_bus.read(); },
+      pattern(false, _, _, _) = [&] { return m_open_bus.read(); });
 }
 
-void mbc3::writeSRAM(address_t index, const byte b) noexcept {
+void mbc3::writeSRAM(const mbc_registers &r, address_t index, const byte b) noexcept {
   using namespace mp;
 
   index = normalize_index(index, mmap::sram);
 
-  match(SRAM_enabled, has_timer, SRAM_bank)(
-      pattern(true, _, anyof(0x00, 0x01, 0x02, 0x03)) = [&] { m_sram[(SRAM_bank * sram_bank_size) + index] = b; },
+  match(r[SRAM_enabled], has_timer, r[SRAM_bank])(
+      pattern(true, _, anyof(0x00, 0x01, 0x02, 0x03)) = [&] { m_sram[sramx_offset + index] = b; },
       pattern(true, true, 0x08) = [&] { RTC.seconds = b & 0x3f; },
       pattern(true, true, 0x09) = [&] { RTC.minutes = b & 0x3f; },
       pattern(true, true, 0x0A) = [&] { RTC.hours = b & 0x1f; },
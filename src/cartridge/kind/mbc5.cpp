@@ -6,9 +6,6 @@
 #include <mpark/patterns/match.hpp>
 #include <mpark/patterns/when.hpp>
 
-#include <range/v3/view/chunk.hpp>
-#include <range/v3/view/const.hpp>
-
 #include <cassert>
 #include <cstddef>
 
@@ -18,58 +15,67 @@
 // https://gekkio.fi/files/gb-docs/gbctr.pdf
 
 namespace LR35902 {
-namespace rv = ranges::views;
 namespace mp = mpark::patterns;
 
-mbc5::mbc5(std::vector<byte> other, const MBC_config& config) :
+mbc5::mbc5(rom_t other, const MBC_config& config, mbc_registers &r) :
     m_rom{std::move(other)},
     m_sram(config.sram_size),
     has_battery{config.has_battery},
-    has_rumble{config.has_rumble} {}
+    has_rumble{config.has_rumble} {
+  r = {};
+  select_banks(r);
+}
+
+void mbc5::select_banks(const mbc_registers &r) noexcept {
+  romx_offset = bank_offset((r[romb_1] << 8) | r[romb_0], rom_bank_size, m_rom->size());
+  sramx_offset = bank_offset(r[ramb], sram_bank_size, m_sram.size());
+}
 
 static_assert((0b1 << 8) == 0b1'0000'0000);
 
 // clang-format off
 byte mbc5::readROM(const address_t index) const noexcept {
-  using namespace mp;
-  static const auto banked_rom_view = m_rom | rv::const_ | rv::chunk(rom_bank_size);
-
-  return match(index)(
-      pattern(arg).when(arg >= mmap::rom0 && arg < mmap::romx) = [&](auto index) { return m_rom[index]; },
-      pattern(arg).when(arg >= mmap::romx && arg < mmap::romx_end) = [&](auto index) {
-            index = normalize_index(index, mmap::romx);
-            return banked_rom_view[((romb_1 << 8) | romb_0)][index]; }
-      );
+  if(index < mmap::romx) return (*m_rom)[index];
+  return (*m_rom)[romx_offset + normalize_index(index, mmap::romx)];
 }
 
-void mbc5::writeROM(const address_t index, const byte b) noexcept {
+void mbc5::writeROM(mbc_registers &r, const address_t index, const byte b) noexcept {
   using namespace mp;
 
   match(index)(
-      pattern(_).when(_ >= 0x0000 && _ < 0x2000) = [&] { ramg = has_rumble ? (b == 0x0A) : ((b & 0x0f) == 0x0A); },
-      pattern(_).when(_ >= 0x2000 && _ < 0x3000) = [&] { romb_0 = b; },
-      pattern(_).when(_ >= 0x3000 && _ < 0x4000) = [&] { romb_1 = b & 0x01; },
-      pattern(_).when(_ >= 0x4000 && _ < 0x6000) = [&] { ramb = b & 0x0f; },
+      pattern(_).when(_ >= 0x0000 && _ < 0x2000) = [&] { r[ramg] = has_rumble ? (b == 0x0A) : ((b & 0x0f) == 0x0A); },
+      pattern(_).when(_ >= 0x2000 && _ < 0x3000) = [&] { r[romb_0] = b; },
+      pattern(_).when(_ >= 0x3000 && _ < 0x4000) = [&] { r[romb_1] = b & 0x01; },
+      pattern(_).when(_ >= 0x4000 && _ < 0x6000) = [&] { r[ramb] = b & 0x0f; },
       pattern(_) = [] {}
       );
+  select_banks(r);
 }
 // clang-format on
 
-[[nodiscard]] byte mbc5::readSRAM(address_t index) const noexcept {
+const byte *mbc5::romxData() const noexcept {
+  if(romx_offset + rom_bank_size > m_rom->size()) return nullptr;
+  return m_rom->data() + romx_offset;
+}
+
+byte *mbc5::sramxData(const mbc_registers &r) noexcept {
+  if(!r[ramg] || sramx_offset + sram_bank_size > m_sram.size()) return nullptr;
+  return m_sram.data() + sramx_offset;
+}
+
+[[nodiscard]] byte mbc5::readSRAM(const mbc_registers &r, address_t index) const noexcept {
   index = normalize_index(index, mmap::sram);
-  static const auto banked_ram_view = m_sram | rv::const_ | rv::chunk(sram_bank_size);
-  if(ramg) {
-    return banked_ram_view[ramb][index];
+  if(r[ramg]) {
+    return m_sram[sramx_offset + index];
   } else {
-    return random_byte();
+    return m_open_bus.read();
   }
 }
 
-void mbc5::writeSRAM(address_t index, const byte b) noexcept {
+void mbc5::writeSRAM(const mbc_registers &r, address_t index, const byte b) noexcept {
   index = normalize_index(index, mmap::sram);
-  static const auto banked_ram_view = m_sram | rv::chunk(sram_bank_size);
-  if(ramg) {
-    banked_ram_view[ramb][index] = b;
+  if(r[ramg]) {
+    m_sram[sramx_offset + index] = b;
   }
 }
 
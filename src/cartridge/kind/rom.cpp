@@ -0,0 +1,66 @@
+#include <LR35902/cartridge/kind/rom.h>
+#include <LR35902/config.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace LR35902 {
+
+std::shared_ptr<const rom_image> rom_image::open(const char *const path) {
+  std::shared_ptr<rom_image> image{new rom_image};
+
+#if defined(__unix__) || defined(__APPLE__)
+  if(const int fd = ::open(path, O_RDONLY | O_CLOEXEC); fd != -1) {
+    struct stat st {};
+    void *mapped = MAP_FAILED;
+    if(::fstat(fd, &st) == 0 && st.st_size > 0)
+      mapped = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file
+
+    if(mapped != MAP_FAILED) {
+      image->m_data = static_cast<const byte *>(mapped);
+      image->m_size = static_cast<std::size_t>(st.st_size);
+      image->m_mapped = true;
+      return image;
+    }
+  }
+#endif
+
+  // can't be mapped, e.g. not a regular file
+  std::ifstream fin{path, std::ios::binary};
+  if(!fin) return nullptr;
+
+  image->m_owned.assign(std::istreambuf_iterator<char>{fin}, {});
+  if(image->m_owned.empty()) return nullptr;
+
+  image->m_data = image->m_owned.data();
+  image->m_size = image->m_owned.size();
+  return image;
+}
+
+std::shared_ptr<const rom_image> rom_image::copy(std::vector<byte> bytes) {
+  std::shared_ptr<rom_image> image{new rom_image};
+  image->m_owned = std::move(bytes);
+  image->m_data = image->m_owned.data();
+  image->m_size = image->m_owned.size();
+  return image;
+}
+
+rom_image::~rom_image() {
+#if defined(__unix__) || defined(__APPLE__)
+  if(m_mapped) ::munmap(const_cast<byte *>(m_data), m_size);
+#endif
+}
+
+}
@@ -7,14 +7,19 @@
 namespace LR35902 {
 
 byte rom_only::readROM(const address_t index) const noexcept {
-  return m_rom[index];
+  return (*m_rom)[index];
 }
 
-void rom_only::writeROM(const address_t index, const byte b) noexcept {
+void rom_only::writeROM(mbc_registers &, const address_t index, const byte b) noexcept {
   // writes has no effect when the cart is rom_only (without static ram, also rom: *read only* memory)
   // on rom_ram it may be used for ram bank selection, when ram size > 8_KiB
   (void)index;
   (void)b;
 }
 
+const byte *rom_only::romxData() const noexcept {
+  if(m_rom->size() < 2_ROMBANK) return nullptr;
+  return m_rom->data() + rom_bank_size;
+}
+
 }
@@ -8,23 +8,34 @@
 
 namespace LR35902 {
 
-rom_ram::rom_ram(std::vector<byte> rom, const MBC_config& config) :
+rom_ram::rom_ram(rom_t rom, const MBC_config& config) :
     m_rom{std::move(rom)},
     has_battery{config.has_battery} {}
 
 byte rom_ram::readROM(const address_t index) const noexcept {
-  return m_rom[index];
+  return (*m_rom)[index];
 }
 
-void rom_ram::writeROM(const address_t index, const byte b) noexcept {
-  m_rom[index] = b;
+void rom_ram::writeROM(mbc_registers &, const address_t index, const byte b) noexcept {
+  // there is no mapper to take the write, and the ROM is read only
+  (void)index;
+  (void)b;
 }
 
-byte rom_ram::readSRAM(const address_t index) const noexcept {
+const byte *rom_ram::romxData() const noexcept {
+  if(m_rom->size() < 2_ROMBANK) return nullptr;
+  return m_rom->data() + rom_bank_size;
+}
+
+byte *rom_ram::sramxData(const mbc_registers &) noexcept {
+  return m_sram.data();
+}
+
+byte rom_ram::readSRAM(const mbc_registers &, const address_t index) const noexcept {
   return m_sram[index];
 }
 
-void rom_ram::writeSRAM(const address_t index, const byte b) noexcept {
+void rom_ram::writeSRAM(const mbc_registers &, const address_t index, const byte b) noexcept {
   m_sram[index] = b;
 }
 
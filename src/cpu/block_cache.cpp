@@ -0,0 +1,113 @@
+#include <LR35902/bus/bus.h>
+#include <LR35902/config.h>
+#include <LR35902/cpu/block_cache.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace LR35902 {
+
+namespace {
+
+// number of bytes CPU::run fetches for each opcode, 0xCB counts the prefixed opcode as its immediate
+// clang-format off
+constexpr std::array<std::uint8_t, 256> instruction_lengths {
+  1, 3, 1, 1, 1, 1, 2, 1, 3, 1, 1, 1, 1, 1, 2, 1,
+  1, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+  2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+  2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 3, 3, 3, 1, 2, 1, 1, 1, 3, 2, 3, 3, 2, 1,
+  1, 1, 3, 1, 3, 1, 2, 1, 1, 1, 3, 1, 3, 1, 2, 1,
+  2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1,
+  2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1
+};
+// clang-format on
+
+// the instructions that may not continue with the next one in memory
+// clang-format off
+constexpr bool ends_block(const byte opcode) noexcept {
+  switch(opcode) {
+  case 0x10: // stop
+  case 0x76: // halt
+  case 0x18: case 0x20: case 0x28: case 0x30: case 0x38: // jr
+  case 0xc2: case 0xc3: case 0xca: case 0xd2: case 0xda: case 0xe9: // jp
+  case 0xc4: case 0xcc: case 0xcd: case 0xd4: case 0xdc: // call
+  case 0xc0: case 0xc8: case 0xc9: case 0xd0: case 0xd8: case 0xd9: // ret, reti
+  case 0xc7: case 0xcf: case 0xd7: case 0xdf: case 0xe7: case 0xef: case 0xf7: case 0xff: // rst
+    return true;
+  default: return false;
+  }
+}
+// clang-format on
+
+}
+
+std::size_t instruction_length(const byte opcode) noexcept {
+  return instruction_lengths[opcode];
+}
+
+std::size_t decode(const byte *const code, const std::size_t available, std::span<micro_op> ops) noexcept {
+  std::size_t decoded = 0;
+
+  for(std::size_t at = 0; decoded < ops.size();) {
+    const byte opcode = code[at];
+    const std::size_t length = instruction_lengths[opcode];
+    if(at + length > available) break;
+
+    micro_op &op = ops[decoded++];
+    op.opcode = opcode;
+    op.operand = {length > 1 ? code[at + 1] : byte{}, length > 2 ? code[at + 2] : byte{}};
+
+    at += length;
+    if(ends_block(opcode)) break;
+  }
+
+  return decoded;
+}
+
+BlockCache::BlockCache(Bus &bus) :
+    m_bus{bus},
+    m_blocks(block_count) {}
+
+const micro_op *BlockCache::enter(const address_t pc) noexcept {
+  m_epoch = m_bus.epoch();
+
+  const std::size_t offset = pc % Bus::page_size;
+  const byte *const page = m_bus.page(pc);
+
+  if(page && offset + instruction_lengths[page[offset]] <= Bus::page_size) {
+    const byte *const code = page + offset;
+    block_t &block = m_blocks[reinterpret_cast<std::uintptr_t>(code) % block_count];
+
+    if(block.key != code || block.version != m_bus.version(pc)) {
+      block.key = code;
+      block.version = m_bus.version(pc);
+      block.length = static_cast<std::uint8_t>(decode(code, Bus::page_size - offset, block.ops));
+      m_bus.protect(pc);
+    }
+
+    m_next = block.ops.data() + 1;
+    m_end = block.ops.data() + block.length;
+    return block.ops.data();
+  }
+
+  // crosses a page boundary or not directly accessible, decode just this one through the bus
+  m_uncached.opcode = m_bus.read(pc);
+  for(std::size_t i = 1; i < instruction_lengths[m_uncached.opcode]; ++i)
+    m_uncached.operand[i - 1] = m_bus.read(static_cast<address_t>(pc + i));
+
+  m_next = m_end = nullptr;
+  return &m_uncached;
+}
+
+}
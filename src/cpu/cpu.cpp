@@ -1,46 +1,33 @@
 #include <LR35902/bus/bus.h>
 #include <LR35902/config.h>
 #include <LR35902/cpu/cpu.h>
+#include <LR35902/cpu/execute.h>
 #include <LR35902/interrupt/interrupt.h>
 #include <LR35902/memory_map.h>
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
 
 namespace LR35902 {
 
+// the bytes come pre-decoded from the block cache, PC still advances as if they were read one by one
 auto CPU::fetchOpcode() noexcept -> byte {
+  if(m_halt_bug) [[unlikely]] {
+    m_halt_bug = false;
+    m_repeated = {m_bus.read(PC.m_data), {m_bus.read(PC.m_data), m_bus.read(PC.m_data + 1)}};
+    m_op = &m_repeated;
+  } else m_op = m_blocks.fetch(PC++);
 #if defined(WITH_DEBUGGER)
   immediate = std::monostate{};
-  opcode = m_bus.read(PC++);
+  opcode = m_op->opcode;
   return opcode;
 #endif
-  return m_bus.read(PC++);
-}
-
-auto CPU::fetchsByte() noexcept -> sbyte {
-#if defined(WITH_DEBUGGER)
-  immediate = static_cast<std::int8_t>(m_bus.read(PC++));
-  return std::get<sbyte>(immediate);
-#endif
-  return m_bus.read(PC++);
-}
-
-auto CPU::fetchByte() noexcept -> byte {
-#if defined(WITH_DEBUGGER)
-  immediate = m_bus.read(PC++);
-  return std::get<byte>(immediate);
-#endif
-  return m_bus.read(PC++);
-}
-
-auto CPU::fetchWord() noexcept -> word {
-  const byte lo = m_bus.read(PC++);
-  const byte hi = m_bus.read(PC++);
-#if defined(WITH_DEBUGGER)
-  immediate = word(hi << 8 | lo);
-  return std::get<word>(immediate);
-#endif
-  return word(hi << 8 | lo);
+  return m_op->opcode;
 }
 
 // interrupt procedure:
@@ -53,6 +40,7 @@ auto CPU::fetchWord() noexcept -> word {
 // interrupt_vector[]{0x40, 0x48, 0x50, 0x58, 0x60};
 void CPU::handleInterrupts() noexcept {
   ime = false;
+  m_blocks.leave();
 
   m_bus.write(--SP.m_data, PC.hi());
   m_bus.write(--SP.m_data, PC.lo());
@@ -88,610 +76,231 @@ void CPU::handleInterrupts() noexcept {
   m_clock.cycle(5);
 }
 
-// opcode table generated from: https://github.com/izik1/gbops/blob/master/dmgops.json
-void CPU::run() noexcept {
+const std::array<handler_t, 256> &CPU::handlers() noexcept {
+  static constexpr std::array<handler_t, 256> handlers = []<std::size_t... Opcodes>(std::index_sequence<Opcodes...>) {
+    return std::array<handler_t, 256>{&CPU::step<static_cast<std::uint8_t>(Opcodes)>...};
+  }(std::make_index_sequence<256>{});
 
-  if(ime && m_bus.interruptHandler.isThereAnAwaitingInterrupt()) {
-    handleInterrupts();
+  return handlers;
+}
+
+const recompiled_block *CPU::findRecompiled() const noexcept {
+  const std::optional<std::size_t> offset = m_bus.romOffset(PC.m_data);
+  if(!offset) return nullptr;
+
+  const auto it = std::ranges::lower_bound(m_recompiled, *offset, {}, &recompiled_block::rom_offset);
+  if(it == m_recompiled.end() || it->rom_offset != *offset) return nullptr;
+  return &*it;
+}
+
+// Enters a recompiled block wherever one starts, everything else (code in RAM, jumps into the middle of a block, code
+// gb.recomp couldn't reach) is interpreted until the next block boundary.
+void CPU::runRecompiled(std::size_t instructions) noexcept {
+  while(instructions != 0 && !m_clock.due()) {
+    if(ime && m_bus.interruptHandler.isThereAnAwaitingInterrupt()) {
+      handleInterrupts();
+    }
+
+    if(m_blocks.atBoundary() && !m_halt_bug) {
+      if(const recompiled_block *const block = findRecompiled(); block && block->length <= instructions) {
+        m_block_epoch = m_bus.epoch();
+        const std::size_t executed = block->code(*this);
+        instructions -= executed;
+        m_retired += executed;
+        m_blocks.leave();
+        continue;
+      }
+    }
+
+    interpret(1);
+    --instructions;
   }
+}
 
-  switch(fetchOpcode()) {
-  case 0x00: nop(); break;
-  case 0x01: ld(BC, n16{fetchWord()}); break;
-  case 0x02:
-    m_bus.write(BC.data(), A.data());
-    m_clock.cycle(2);
-    break;
-  case 0x03: inc(BC); break;
-  case 0x04: inc(B); break;
-  case 0x05: dec(B); break;
-  case 0x06: ld(B, n8{fetchByte()}); break;
-  case 0x07: rlca(); break;
-  case 0x08: {
-    const n16 nn{fetchWord()};
+// DIV and TIMA advance without any event scheduled, a loop polling them sees a new value every time around
+[[nodiscard]] constexpr bool isPolledByEvents(const address_t address) noexcept {
+  return address != 0xff04 && address != 0xff05;
+}
 
-    m_bus.write(nn.m_data + 1, SP.hi());
-    m_bus.write(nn.m_data, SP.lo());
+// Whether the loop leaves the memory and the registers it reads as they were, so that each iteration repeats the
+// previous one: it reads memory into A first and doesn't write anything else than A and the flags.
+bool CPU::isPollingLoop(const byte *const code, const std::size_t length) const noexcept {
+  std::array<micro_op, BlockCache::max_block_length> ops;
+  const std::size_t count = decode(code, length, ops);
 
-    m_clock.cycle(5);
+  std::size_t decoded = 0;
+  for(std::size_t i = 0; i < count; ++i)
+    decoded += instruction_length(ops[i].opcode);
+  if(count == 0 || decoded != length) return false; // the jump back isn't the end of the straight-line code
+
+  // clang-format off
+  switch(ops[count - 1].opcode) {
+  case 0x18: case 0x20: case 0x28: case 0x30: case 0x38: // jr
+  case 0xc3: case 0xc2: case 0xca: case 0xd2: case 0xda: // jp
     break;
+  default: return false;
   }
-  case 0x09: add(HL_register_tag, BC); break;
-  case 0x0a: ld(memory_to_register, *BC); break;
-  case 0x0b: dec(BC); break;
-  case 0x0c: inc(C); break;
-  case 0x0d: dec(C); break;
-  case 0x0e: ld(C, n8{fetchByte()}); break;
-  case 0x0f: rrca(); break;
-  case 0x10: stop(); break;
-  case 0x11: ld(DE, n16{fetchWord()}); break;
-  case 0x12:
-    m_bus.write(DE.data(), A.data());
-    m_clock.cycle(2);
-    break;
+  // clang-format on
+
+  bool loaded = false; // A holds what was read this time around
+  for(std::size_t i = 0; i + 1 < count; ++i) {
+    const micro_op &op = ops[i];
+    const address_t immediate = op.operand[1] << 8 | op.operand[0];
 
-  case 0x13: inc(DE); break;
-  case 0x14: inc(D); break;
-  case 0x15: dec(D); break;
-  case 0x16: ld(D, n8{fetchByte()}); break;
-  case 0x17: rla(); break;
-  case 0x18: jr(e8{fetchsByte()}); break;
-  case 0x19: add(HL_register_tag, DE); break;
-  case 0x1a: ld(memory_to_register, *DE); break;
-  case 0x1b: dec(DE); break;
-  case 0x1c: inc(E); break;
-  case 0x1d: dec(E); break;
-  case 0x1e: ld(E, n8{fetchByte()}); break;
-  case 0x1f: rra(); break;
-  case 0x20: jr(cc::nz, e8{fetchsByte()}); break;
-  case 0x21: ld(HL, n16{fetchWord()}); break;
-  case 0x22:
-    m_bus.write(HL.data(), A.data());
-    ++HL;
-    m_clock.cycle(2);
-    break;
-  case 0x23: inc(HL); break;
-  case 0x24: inc(H); break;
-  case 0x25: dec(H); break;
-  case 0x26: ld(H, n8{fetchByte()}); break;
-  case 0x27: daa(); break;
-  case 0x28: jr(cc::z, e8{fetchsByte()}); break;
-  case 0x29: add(HL_register_tag, HL); break;
-  case 0x2a: ld(memory_to_register, HLi_tag); break;
-  case 0x2b: dec(HL); break;
-  case 0x2c: inc(L); break;
-  case 0x2d: dec(L); break;
-  case 0x2e: ld(L, n8{fetchByte()}); break;
-  case 0x2f: cpl(); break;
-  case 0x30: jr(cc::nc, e8{fetchsByte()}); break;
-  case 0x31: ld(SP_register_tag, n16{fetchWord()}); break;
-  case 0x32:
-    m_bus.write(HL.data(), A.data());
-    --HL;
-    m_clock.cycle(2);
-    break;
-  case 0x33: inc(SP_register_tag); break;
-  case 0x34: inc(*HL); break;
-  case 0x35: dec(*HL); break;
-  case 0x36:
-    m_bus.write(HL.data(), fetchByte());
-    m_clock.cycle(3);
-    break;
-  case 0x37: scf(); break;
-  case 0x38: jr(cc::c, e8{fetchsByte()}); break;
-  case 0x39: add(HL_register_tag, SP_register_tag); break;
-  case 0x3a: ld(memory_to_register, HLd_tag); break;
-  case 0x3b: dec(SP_register_tag); break;
-  case 0x3c: inc(A); break;
-  case 0x3d: dec(A); break;
-  case 0x3e: ld(A, n8{fetchByte()}); break;
-  case 0x3f: ccf(); break;
-
-  case 0x40: ld(B, B); break;
-  case 0x41: ld(B, C); break;
-  case 0x42: ld(B, D); break;
-  case 0x43: ld(B, E); break;
-  case 0x44: ld(B, H); break;
-  case 0x45: ld(B, L); break;
-  case 0x46: ld(B, *HL); break;
-  case 0x47: ld(B, A); break;
-
-  case 0x48: ld(C, B); break;
-  case 0x49: ld(C, C); break;
-  case 0x4a: ld(C, D); break;
-  case 0x4b: ld(C, E); break;
-  case 0x4c: ld(C, H); break;
-  case 0x4d: ld(C, L); break;
-  case 0x4e: ld(C, *HL); break;
-  case 0x4f: ld(C, A); break;
-
-  case 0x50: ld(D, B); break;
-  case 0x51: ld(D, C); break;
-  case 0x52: ld(D, D); break;
-  case 0x53: ld(D, E); break;
-  case 0x54: ld(D, H); break;
-  case 0x55: ld(D, L); break;
-  case 0x56: ld(D, *HL); break;
-  case 0x57: ld(D, A); break;
-
-  case 0x58: ld(E, B); break;
-  case 0x59: ld(E, C); break;
-  case 0x5a: ld(E, D); break;
-  case 0x5b: ld(E, E); break;
-  case 0x5c: ld(E, H); break;
-  case 0x5d: ld(E, L); break;
-  case 0x5e: ld(E, *HL); break;
-  case 0x5f: ld(E, A); break;
-
-  case 0x60: ld(H, B); break;
-  case 0x61: ld(H, C); break;
-  case 0x62: ld(H, D); break;
-  case 0x63: ld(H, E); break;
-  case 0x64: ld(H, H); break;
-  case 0x65: ld(H, L); break;
-  case 0x66: ld(H, *HL); break;
-  case 0x67: ld(H, A); break;
-  case 0x68: ld(L, B); break;
-  case 0x69: ld(L, C); break;
-  case 0x6a: ld(L, D); break;
-  case 0x6b: ld(L, E); break;
-  case 0x6c: ld(L, H); break;
-  case 0x6d: ld(L, L); break;
-  case 0x6e: ld(L, *HL); break;
-  case 0x6f:
-    ld(L, A);
-    break;
     // clang-format off
-  case 0x70: m_bus.write(HL.data(), B.data()); m_clock.cycle(2); break;
-  case 0x71: m_bus.write(HL.data(), C.data()); m_clock.cycle(2); break;
-  case 0x72: m_bus.write(HL.data(), D.data()); m_clock.cycle(2); break;
-  case 0x73: m_bus.write(HL.data(), E.data()); m_clock.cycle(2); break;
-  case 0x74: m_bus.write(HL.data(), H.data()); m_clock.cycle(2); break;
-  case 0x75: m_bus.write(HL.data(), L.data()); m_clock.cycle(2); break;
-  // clang-format on
-  case 0x76: halt(); break;
-  case 0x77:
-    m_bus.write(HL.data(), A.data());
-    m_clock.cycle(2);
-    break;
-  case 0x78: ld(A, B); break;
-  case 0x79: ld(A, C); break;
-  case 0x7a: ld(A, D); break;
-  case 0x7b: ld(A, E); break;
-  case 0x7c: ld(A, H); break;
-  case 0x7d: ld(A, L); break;
-  case 0x7e: ld(A, *HL); break;
-  case 0x7f: ld(A, A); break;
-
-  case 0x80: add(B); break;
-  case 0x81: add(C); break;
-  case 0x82: add(D); break;
-  case 0x83: add(E); break;
-  case 0x84: add(H); break;
-  case 0x85: add(L); break;
-  case 0x86: add(*HL); break;
-  case 0x87: add(A); break;
-
-  case 0x88: adc(B); break;
-  case 0x89: adc(C); break;
-  case 0x8a: adc(D); break;
-  case 0x8b: adc(E); break;
-  case 0x8c: adc(H); break;
-  case 0x8d: adc(L); break;
-  case 0x8e: adc(*HL); break;
-  case 0x8f: adc(A); break;
-
-  case 0x90: sub(B); break;
-  case 0x91: sub(C); break;
-  case 0x92: sub(D); break;
-  case 0x93: sub(E); break;
-  case 0x94: sub(H); break;
-  case 0x95: sub(L); break;
-  case 0x96: sub(*HL); break;
-  case 0x97: sub(A); break;
-
-  case 0x98: sbc(B); break;
-  case 0x99: sbc(C); break;
-  case 0x9a: sbc(D); break;
-  case 0x9b: sbc(E); break;
-  case 0x9c: sbc(H); break;
-  case 0x9d: sbc(L); break;
-  case 0x9e: sbc(*HL); break;
-  case 0x9f: sbc(A); break;
-
-  case 0xa0: and_(B); break;
-  case 0xa1: and_(C); break;
-  case 0xa2: and_(D); break;
-  case 0xa3: and_(E); break;
-  case 0xa4: and_(H); break;
-  case 0xa5: and_(L); break;
-  case 0xa6: and_(*HL); break;
-  case 0xa7: and_(A); break;
-
-  case 0xa8: xor_(B); break;
-  case 0xa9: xor_(C); break;
-  case 0xaa: xor_(D); break;
-  case 0xab: xor_(E); break;
-  case 0xac: xor_(H); break;
-  case 0xad: xor_(L); break;
-  case 0xae: xor_(*HL); break;
-  case 0xaf: xor_(A); break;
-
-  case 0xb0: or_(B); break;
-  case 0xb1: or_(C); break;
-  case 0xb2: or_(D); break;
-  case 0xb3: or_(E); break;
-  case 0xb4: or_(H); break;
-  case 0xb5: or_(L); break;
-  case 0xb6: or_(*HL); break;
-  case 0xb7: or_(A); break;
-
-  case 0xb8: cp(B); break;
-  case 0xb9: cp(C); break;
-  case 0xba: cp(D); break;
-  case 0xbb: cp(E); break;
-  case 0xbc: cp(H); break;
-  case 0xbd: cp(L); break;
-  case 0xbe: cp(*HL); break;
-  case 0xbf: cp(A); break;
-  case 0xc0: ret(cc::nz); break;
-  case 0xc1: pop(BC); break;
-  case 0xc2: jp(cc::nz, n16{fetchWord()}); break;
-  case 0xc3: jp(n16{fetchWord()}); break;
-  case 0xc4: call(cc::nz, n16{fetchWord()}); break;
-  case 0xc5: push(BC); break;
-  case 0xc6: add(n8{fetchByte()}); break;
-  case 0xc7: rst(mmap::rst_00); break;
-  case 0xc8: ret(cc::z); break;
-  case 0xc9: ret(); break;
-  case 0xca: jp(cc::z, n16{fetchWord()}); break;
-  case 0xcb:
-    switch(fetchByte()) {
-    case 0x0: rlc(B); break;
-    case 0x1: rlc(C); break;
-    case 0x2: rlc(D); break;
-    case 0x3: rlc(E); break;
-    case 0x4: rlc(H); break;
-    case 0x5: rlc(L); break;
-    case 0x6: rlc(*HL); break;
-    case 0x7: rlc(A); break;
-
-    case 0x8: rrc(B); break;
-    case 0x9: rrc(C); break;
-    case 0xa: rrc(D); break;
-    case 0xb: rrc(E); break;
-    case 0xc: rrc(H); break;
-    case 0xd: rrc(L); break;
-    case 0xe: rrc(*HL); break;
-    case 0xf: rrc(A); break;
-
-    case 0x10: rl(B); break;
-    case 0x11: rl(C); break;
-    case 0x12: rl(D); break;
-    case 0x13: rl(E); break;
-    case 0x14: rl(H); break;
-    case 0x15: rl(L); break;
-    case 0x16: rl(*HL); break;
-    case 0x17: rl(A); break;
-
-    case 0x18: rr(B); break;
-    case 0x19: rr(C); break;
-    case 0x1a: rr(D); break;
-    case 0x1b: rr(E); break;
-    case 0x1c: rr(H); break;
-    case 0x1d: rr(L); break;
-    case 0x1e: rr(*HL); break;
-    case 0x1f: rr(A); break;
-
-    case 0x20: sla(B); break;
-    case 0x21: sla(C); break;
-    case 0x22: sla(D); break;
-    case 0x23: sla(E); break;
-    case 0x24: sla(H); break;
-    case 0x25: sla(L); break;
-    case 0x26: sla(*HL); break;
-    case 0x27: sla(A); break;
-
-    case 0x28: sra(B); break;
-    case 0x29: sra(C); break;
-    case 0x2a: sra(D); break;
-    case 0x2b: sra(E); break;
-    case 0x2c: sra(H); break;
-    case 0x2d: sra(L); break;
-    case 0x2e: sra(*HL); break;
-    case 0x2f: sra(A); break;
-
-    case 0x30: swap(B); break;
-    case 0x31: swap(C); break;
-    case 0x32: swap(D); break;
-    case 0x33: swap(E); break;
-    case 0x34: swap(H); break;
-    case 0x35: swap(L); break;
-    case 0x36: swap(*HL); break;
-    case 0x37: swap(A); break;
-
-    case 0x38: srl(B); break;
-    case 0x39: srl(C); break;
-    case 0x3a: srl(D); break;
-    case 0x3b: srl(E); break;
-    case 0x3c: srl(H); break;
-    case 0x3d: srl(L); break;
-    case 0x3e: srl(*HL); break;
-    case 0x3f: srl(A); break;
-
-    case 0x40: bit(u3{0}, B); break;
-    case 0x41: bit(u3{0}, C); break;
-    case 0x42: bit(u3{0}, D); break;
-    case 0x43: bit(u3{0}, E); break;
-    case 0x44: bit(u3{0}, H); break;
-    case 0x45: bit(u3{0}, L); break;
-    case 0x46: bit(u3{0}, *HL); break;
-    case 0x47: bit(u3{0}, A); break;
-    case 0x48: bit(u3{1}, B); break;
-    case 0x49: bit(u3{1}, C); break;
-    case 0x4a: bit(u3{1}, D); break;
-    case 0x4b: bit(u3{1}, E); break;
-    case 0x4c: bit(u3{1}, H); break;
-    case 0x4d: bit(u3{1}, L); break;
-    case 0x4e: bit(u3{1}, *HL); break;
-    case 0x4f: bit(u3{1}, A); break;
-    case 0x50: bit(u3{2}, B); break;
-    case 0x51: bit(u3{2}, C); break;
-    case 0x52: bit(u3{2}, D); break;
-    case 0x53: bit(u3{2}, E); break;
-    case 0x54: bit(u3{2}, H); break;
-    case 0x55: bit(u3{2}, L); break;
-    case 0x56: bit(u3{2}, *HL); break;
-    case 0x57: bit(u3{2}, A); break;
-    case 0x58: bit(u3{3}, B); break;
-    case 0x59: bit(u3{3}, C); break;
-    case 0x5a: bit(u3{3}, D); break;
-    case 0x5b: bit(u3{3}, E); break;
-    case 0x5c: bit(u3{3}, H); break;
-    case 0x5d: bit(u3{3}, L); break;
-    case 0x5e: bit(u3{3}, *HL); break;
-    case 0x5f: bit(u3{3}, A); break;
-    case 0x60: bit(u3{4}, B); break;
-    case 0x61: bit(u3{4}, C); break;
-    case 0x62: bit(u3{4}, D); break;
-    case 0x63: bit(u3{4}, E); break;
-    case 0x64: bit(u3{4}, H); break;
-    case 0x65: bit(u3{4}, L); break;
-    case 0x66: bit(u3{4}, *HL); break;
-    case 0x67: bit(u3{4}, A); break;
-    case 0x68: bit(u3{5}, B); break;
-    case 0x69: bit(u3{5}, C); break;
-    case 0x6a: bit(u3{5}, D); break;
-    case 0x6b: bit(u3{5}, E); break;
-    case 0x6c: bit(u3{5}, H); break;
-    case 0x6d: bit(u3{5}, L); break;
-    case 0x6e: bit(u3{5}, *HL); break;
-    case 0x6f: bit(u3{5}, A); break;
-    case 0x70: bit(u3{6}, B); break;
-    case 0x71: bit(u3{6}, C); break;
-    case 0x72: bit(u3{6}, D); break;
-    case 0x73: bit(u3{6}, E); break;
-    case 0x74: bit(u3{6}, H); break;
-    case 0x75: bit(u3{6}, L); break;
-    case 0x76: bit(u3{6}, *HL); break;
-    case 0x77: bit(u3{6}, A); break;
-    case 0x78: bit(u3{7}, B); break;
-    case 0x79: bit(u3{7}, C); break;
-    case 0x7a: bit(u3{7}, D); break;
-    case 0x7b: bit(u3{7}, E); break;
-    case 0x7c: bit(u3{7}, H); break;
-    case 0x7d: bit(u3{7}, L); break;
-    case 0x7e: bit(u3{7}, *HL); break;
-    case 0x7f: bit(u3{7}, A); break;
-
-    case 0x80: res(u3{0}, B); break;
-    case 0x81: res(u3{0}, C); break;
-    case 0x82: res(u3{0}, D); break;
-    case 0x83: res(u3{0}, E); break;
-    case 0x84: res(u3{0}, H); break;
-    case 0x85: res(u3{0}, L); break;
-    case 0x86: res(u3{0}, *HL); break;
-    case 0x87: res(u3{0}, A); break;
-    case 0x88: res(u3{1}, B); break;
-    case 0x89: res(u3{1}, C); break;
-    case 0x8a: res(u3{1}, D); break;
-    case 0x8b: res(u3{1}, E); break;
-    case 0x8c: res(u3{1}, H); break;
-    case 0x8d: res(u3{1}, L); break;
-    case 0x8e: res(u3{1}, *HL); break;
-    case 0x8f: res(u3{1}, A); break;
-    case 0x90: res(u3{2}, B); break;
-    case 0x91: res(u3{2}, C); break;
-    case 0x92: res(u3{2}, D); break;
-    case 0x93: res(u3{2}, E); break;
-    case 0x94: res(u3{2}, H); break;
-    case 0x95: res(u3{2}, L); break;
-    case 0x96: res(u3{2}, *HL); break;
-    case 0x97: res(u3{2}, A); break;
-    case 0x98: res(u3{3}, B); break;
-    case 0x99: res(u3{3}, C); break;
-    case 0x9a: res(u3{3}, D); break;
-    case 0x9b: res(u3{3}, E); break;
-    case 0x9c: res(u3{3}, H); break;
-    case 0x9d: res(u3{3}, L); break;
-    case 0x9e: res(u3{3}, *HL); break;
-    case 0x9f: res(u3{3}, A); break;
-    case 0xa0: res(u3{4}, B); break;
-    case 0xa1: res(u3{4}, C); break;
-    case 0xa2: res(u3{4}, D); break;
-    case 0xa3: res(u3{4}, E); break;
-    case 0xa4: res(u3{4}, H); break;
-    case 0xa5: res(u3{4}, L); break;
-    case 0xa6: res(u3{4}, *HL); break;
-    case 0xa7: res(u3{4}, A); break;
-    case 0xa8: res(u3{5}, B); break;
-    case 0xa9: res(u3{5}, C); break;
-    case 0xaa: res(u3{5}, D); break;
-    case 0xab: res(u3{5}, E); break;
-    case 0xac: res(u3{5}, H); break;
-    case 0xad: res(u3{5}, L); break;
-    case 0xae: res(u3{5}, *HL); break;
-    case 0xaf: res(u3{5}, A); break;
-    case 0xb0: res(u3{6}, B); break;
-    case 0xb1: res(u3{6}, C); break;
-    case 0xb2: res(u3{6}, D); break;
-    case 0xb3: res(u3{6}, E); break;
-    case 0xb4: res(u3{6}, H); break;
-    case 0xb5: res(u3{6}, L); break;
-    case 0xb6: res(u3{6}, *HL); break;
-    case 0xb7: res(u3{6}, A); break;
-    case 0xb8: res(u3{7}, B); break;
-    case 0xb9: res(u3{7}, C); break;
-    case 0xba: res(u3{7}, D); break;
-    case 0xbb: res(u3{7}, E); break;
-    case 0xbc: res(u3{7}, H); break;
-    case 0xbd: res(u3{7}, L); break;
-    case 0xbe: res(u3{7}, *HL); break;
-    case 0xbf: res(u3{7}, A); break;
-
-    case 0xc0: set(u3{0}, B); break;
-    case 0xc1: set(u3{0}, C); break;
-    case 0xc2: set(u3{0}, D); break;
-    case 0xc3: set(u3{0}, E); break;
-    case 0xc4: set(u3{0}, H); break;
-    case 0xc5: set(u3{0}, L); break;
-    case 0xc6: set(u3{0}, *HL); break;
-    case 0xc7: set(u3{0}, A); break;
-    case 0xc8: set(u3{1}, B); break;
-    case 0xc9: set(u3{1}, C); break;
-    case 0xca: set(u3{1}, D); break;
-    case 0xcb: set(u3{1}, E); break;
-    case 0xcc: set(u3{1}, H); break;
-    case 0xcd: set(u3{1}, L); break;
-    case 0xce: set(u3{1}, *HL); break;
-    case 0xcf: set(u3{1}, A); break;
-    case 0xd0: set(u3{2}, B); break;
-    case 0xd1: set(u3{2}, C); break;
-    case 0xd2: set(u3{2}, D); break;
-    case 0xd3: set(u3{2}, E); break;
-    case 0xd4: set(u3{2}, H); break;
-    case 0xd5: set(u3{2}, L); break;
-    case 0xd6: set(u3{2}, *HL); break;
-    case 0xd7: set(u3{2}, A); break;
-    case 0xd8: set(u3{3}, B); break;
-    case 0xd9: set(u3{3}, C); break;
-    case 0xda: set(u3{3}, D); break;
-    case 0xdb: set(u3{3}, E); break;
-    case 0xdc: set(u3{3}, H); break;
-    case 0xdd: set(u3{3}, L); break;
-    case 0xde: set(u3{3}, *HL); break;
-    case 0xdf: set(u3{3}, A); break;
-    case 0xe0: set(u3{4}, B); break;
-    case 0xe1: set(u3{4}, C); break;
-    case 0xe2: set(u3{4}, D); break;
-    case 0xe3: set(u3{4}, E); break;
-    case 0xe4: set(u3{4}, H); break;
-    case 0xe5: set(u3{4}, L); break;
-    case 0xe6: set(u3{4}, *HL); break;
-    case 0xe7: set(u3{4}, A); break;
-    case 0xe8: set(u3{5}, B); break;
-    case 0xe9: set(u3{5}, C); break;
-    case 0xea: set(u3{5}, D); break;
-    case 0xeb: set(u3{5}, E); break;
-    case 0xec: set(u3{5}, H); break;
-    case 0xed: set(u3{5}, L); break;
-    case 0xee: set(u3{5}, *HL); break;
-    case 0xef: set(u3{5}, A); break;
-    case 0xf0: set(u3{6}, B); break;
-    case 0xf1: set(u3{6}, C); break;
-    case 0xf2: set(u3{6}, D); break;
-    case 0xf3: set(u3{6}, E); break;
-    case 0xf4: set(u3{6}, H); break;
-    case 0xf5: set(u3{6}, L); break;
-    case 0xf6: set(u3{6}, *HL); break;
-    case 0xf7: set(u3{6}, A); break;
-    case 0xf8: set(u3{7}, B); break;
-    case 0xf9: set(u3{7}, C); break;
-    case 0xfa: set(u3{7}, D); break;
-    case 0xfb: set(u3{7}, E); break;
-    case 0xfc: set(u3{7}, H); break;
-    case 0xfd: set(u3{7}, L); break;
-    case 0xfe: set(u3{7}, *HL); break;
-    case 0xff: set(u3{7}, A); break;
+    switch(op.opcode) {
+    case 0x00: break; // nop
+
+    case 0xf0: loaded = isPolledByEvents(0xff00 + op.operand[0]); break; // ldh A,[n8]
+    case 0xf2: loaded = isPolledByEvents(0xff00 + C.data()); break;      // ldh A,[C]
+    case 0xfa: loaded = isPolledByEvents(immediate); break;              // ld A,[n16]
+    case 0x0a: loaded = isPolledByEvents(BC.data()); break;              // ld A,[BC]
+    case 0x1a: loaded = isPolledByEvents(DE.data()); break;              // ld A,[DE]
+    case 0x7e: loaded = isPolledByEvents(HL.data()); break;              // ld A,[HL]
+
+    case 0xc6: case 0xd6: case 0xe6: case 0xee: case 0xf6: case 0xfe: // add, sub, and, xor, or, cp A,n8
+      if(!loaded) return false;
+      break;
+
+    case 0xcb: // bit u3,r8; the others write what they read
+      if(op.operand[0] < 0x40 || op.operand[0] > 0x7f) return false;
+      if((op.operand[0] & 0b111) == 0b111 && !loaded) return false;
+      if((op.operand[0] & 0b111) == 0b110 && !isPolledByEvents(HL.data())) return false;
+      break;
+
+    default:
+      // add, sub, and, xor, or, cp A,r8 and A,[HL]; adc and sbc read the carry of the previous time around
+      if(op.opcode < 0x80 || op.opcode > 0xbf || (op.opcode >= 0x88 && op.opcode <= 0x8f) ||
+         (op.opcode >= 0x98 && op.opcode <= 0x9f) || !loaded)
+        return false;
+      if((op.opcode & 0b111) == 0b110 && !isPolledByEvents(HL.data())) return false;
     }
-    break;
-
-  case 0xcc: call(cc::z, n16{fetchWord()}); break;
-  case 0xcd: call(n16{fetchWord()}); break;
-  case 0xce: adc(n8{fetchByte()}); break;
-  case 0xcf: rst(mmap::rst_08); break;
-  case 0xd0: ret(cc::nc); break;
-  case 0xd1: pop(DE); break;
-  case 0xd2: jp(cc::nc, n16{fetchWord()}); break;
-  case 0xd3: unused(); break;
-  case 0xd4: call(cc::nc, n16{fetchWord()}); break;
-  case 0xd5: push(DE); break;
-  case 0xd6: sub(n8{fetchByte()}); break;
-  case 0xd7: rst(mmap::rst_10); break;
-  case 0xd8: ret(cc::c); break;
-  case 0xd9: reti(); break;
-  case 0xda: jp(cc::c, n16{fetchWord()}); break;
-  case 0xdb: unused(); break;
-  case 0xdc: call(cc::c, n16{fetchWord()}); break;
-  case 0xdd: unused(); break;
-  case 0xde: sbc(n8{fetchByte()}); break;
-  case 0xdf: rst(mmap::rst_18); break;
-  case 0xe0: ldh(0xFF00 + fetchByte(), register_to_memory); break;
-  case 0xe1: pop(HL); break;
-  case 0xe2: ldh(0xFF00 + C.data(), register_to_memory, C_register_tag); break;
-  case 0xe3: unused(); break;
-  case 0xe4: unused(); break;
-  case 0xe5: push(HL); break;
-  case 0xe6: and_(n8{fetchByte()}); break;
-  case 0xe7: rst(mmap::rst_20); break;
-  case 0xe8: add(SP_register_tag, e8{fetchsByte()}); break;
-  case 0xe9: jp(HL_register_tag); break;
-  case 0xea: {
-    const n16 nn{fetchWord()};
-    m_bus.write(nn.m_data, A.data());
+    // clang-format on
 
-    m_clock.cycle(4);
-    break;
+    if(!loaded && op.opcode != 0x00 && op.opcode != 0xcb) return false;
   }
-  case 0xeb: unused(); break;
-  case 0xec: unused(); break;
-  case 0xed: unused(); break;
-  case 0xee: xor_(n8{fetchByte()}); break;
-  case 0xef: rst(mmap::rst_28); break;
-  case 0xf0: {
-    const byte b = m_bus.read(0xff00 + fetchByte());
-    ldh(memory_to_register, b);
-    break;
+
+  return true;
+}
+
+// PC was just set to the start of a loop that ends at end
+void CPU::idleLoop(const address_t end) noexcept {
+  if(!m_skip_idle_loops) return;
+
+  const address_t start = PC.m_data;
+  const byte *const page = m_bus.page(start);
+  if(!page || start / Bus::page_size != (end - 1) / Bus::page_size) return;
+
+  const byte *const code = page + start % Bus::page_size;
+  const std::uint64_t now = m_clock.data();
+
+  if(m_idle_loop.code != code || m_idle_loop.version != m_bus.version(start) || m_idle_loop.bc != BC.data() ||
+     m_idle_loop.de != DE.data() || m_idle_loop.hl != HL.data()) {
+    m_idle_loop = {.code = code,
+                   .version = m_bus.version(start),
+                   .bc = BC.data(),
+                   .de = DE.data(),
+                   .hl = HL.data(),
+                   .polling = isPollingLoop(code, end - start),
+                   .last = now,
+                   .deadline = m_clock.deadline()};
+    return;
   }
-  case 0xf1: pop(AF_register_tag); break;
-  case 0xf2: {
-    const byte b = m_bus.read(0xFF00 + C.data());
-    ldh(memory_to_register, b, C_register_tag);
-    break;
+  if(!m_idle_loop.polling) return;
+
+  const std::uint64_t deadline = m_clock.deadline();
+  const std::uint64_t period = now - m_idle_loop.last;
+  m_idle_loop.last = now;
+  // something else ran in between, e.g. an interrupt handler, or an event passed after the loop read the memory
+  if(period != m_idle_loop.period || deadline != m_idle_loop.deadline) {
+    m_idle_loop.period = period;
+    m_idle_loop.deadline = deadline;
+    return;
   }
-  case 0xf3: di(); break;
-  case 0xf4: unused(); break;
-  case 0xf5: push(AF_register_tag); break;
-  case 0xf6: or_(n8{fetchByte()}); break;
-  case 0xf7: rst(mmap::rst_30); break;
-  case 0xf8: ld(HL_register_tag, SP_register_tag, e8{fetchsByte()}); break;
-  case 0xf9: ld(SP_register_tag, HL_register_tag); break;
-  case 0xfa: { // ld A,[n16]
-    const n16 nn{fetchWord()};
-    A = m_bus.read(nn.m_data);
-    m_clock.cycle(4);
-    break;
+
+  if(deadline == std::numeric_limits<std::uint64_t>::max() || deadline <= now || period == 0) return;
+  if(ime && m_bus.interruptHandler.isThereAnAwaitingInterrupt()) return;
+
+  const std::uint64_t skipped = (deadline - now) / period * period;
+  m_clock.cycle(skipped);
+  m_idle_loop.last += skipped;
+  m_skipped_cycles += skipped;
+}
+
+#if defined(THREADED_DISPATCH) && (defined(__GNUC__) || defined(__clang__))
+  #define LR35902_THREADED_DISPATCH
+#endif
+
+// The opcode table below is written once and expanded into one of the two interpreter cores:
+// - switch: the portable one, every instruction goes back to the top of the loop and the single indirect branch of the
+//   switch.
+// - threaded: uses labels as values (a GNU extension). Each handler ends with its own copy of the dispatch, so the host
+//   branch predictor sees one indirect branch per opcode and can learn which opcode tends to follow which.
+#if defined(LR35902_THREADED_DISPATCH)
+  #define OPCODE(n) op_##n:
+  #define CB_OPCODE(n) cb_##n:
+  #define DISPATCH(b) goto *opcodes[b];
+  #define CB_DISPATCH(b) goto *cb_opcodes[b];
+  #define NEXT                                                                             \
+    do {                                                                                   \
+      if(instructions == 0 || m_clock.due()) goto retire;                                  \
+      --instructions;                                                                      \
+      if(ime && m_bus.interruptHandler.isThereAnAwaitingInterrupt()) handleInterrupts(); \
+      goto *opcodes[fetchOpcode()];                                                        \
+    } while(0)
+
+  #define LABEL_ROW(p, h)                                                                                  \
+    &&p##h##0, &&p##h##1, &&p##h##2, &&p##h##3, &&p##h##4, &&p##h##5, &&p##h##6, &&p##h##7, &&p##h##8, \
+        &&p##h##9, &&p##h##a, &&p##h##b, &&p##h##c, &&p##h##d, &&p##h##e, &&p##h##f
+  #define LABEL_TABLE(p)                                                                                               \
+    LABEL_ROW(p, 0), LABEL_ROW(p, 1), LABEL_ROW(p, 2), LABEL_ROW(p, 3), LABEL_ROW(p, 4), LABEL_ROW(p, 5),            \
+        LABEL_ROW(p, 6), LABEL_ROW(p, 7), LABEL_ROW(p, 8), LABEL_ROW(p, 9), LABEL_ROW(p, a), LABEL_ROW(p, b),        \
+        LABEL_ROW(p, c), LABEL_ROW(p, d), LABEL_ROW(p, e), LABEL_ROW(p, f)
+#else
+  #define OPCODE(n) case n:
+  #define CB_OPCODE(n) case n:
+  #define DISPATCH(b) switch(b)
+  #define CB_DISPATCH(b) switch(b)
+  #define NEXT break
+#endif
+
+void CPU::interpret(std::size_t instructions) noexcept {
+#if defined(LR35902_THREADED_DISPATCH)
+  static const void *const opcodes[256] = {LABEL_TABLE(op_0x)};
+  static const void *const cb_opcodes[256] = {LABEL_TABLE(cb_0x)};
+#endif
+  const std::size_t budget = instructions;
+
+next:
+  if(instructions == 0 || m_clock.due()) goto retire;
+
+  if(ime && m_bus.interruptHandler.isThereAnAwaitingInterrupt()) {
+    handleInterrupts();
   }
-  case 0xfb: ei(); break;
-  case 0xfc: unused(); break;
-  case 0xfd: unused(); break;
-  case 0xfe: cp(n8{fetchByte()}); break;
-  case 0xff: rst(mmap::rst_38); break;
+
+  --instructions;
+  DISPATCH(fetchOpcode()) {
+#include <LR35902/cpu/opcodes.inc>
   }
+  goto next;
+
+retire: // counted once per call, the loop itself stays as it is
+  m_retired += budget - instructions;
 }
 
+#undef OPCODE
+#undef CB_OPCODE
+#undef DISPATCH
+#undef CB_DISPATCH
+#undef NEXT
+#if defined(LR35902_THREADED_DISPATCH)
+  #undef LABEL_ROW
+  #undef LABEL_TABLE
+#endif
+
 // https://gbdev.io/pandocs/Power_Up_Sequence.html#cpu-registers
 void CPU::setPostBootValues() noexcept {
+  dropFlags();
   A = 0x01;
   F = {.z = 1, .n = 0, .h = 1, .c = 1};
 
@@ -706,88 +315,108 @@ void CPU::setPostBootValues() noexcept {
 
   PC.m_data = 0x0100;
   SP.m_data = 0xfffe;
+
+  m_blocks.leave();
 }
 
 void CPU::reset() noexcept {
-  A = byte{};
-  F = flags{};
-
-  B = C = D = E = H = L = byte{};
+  m_registers = register_file{};
+  dropFlags();
+  mode = mode_t::running;
+  m_halt_bug = false;
+  m_blocks.leave();
+}
 
-  SP = n16{};
-  PC = n16{};
+CPU &CPU::operator=(const CPU &other) noexcept {
+#if defined(LAZY_FLAGS)
+  m_lazy = other.m_lazy;
+#endif
+  mode = other.mode;
+  m_halt_bug = other.m_halt_bug;
+  m_repeated = other.m_repeated;
+  m_retired = other.m_retired;
+  m_skipped_cycles = other.m_skipped_cycles;
+  m_skip_idle_loops = other.m_skip_idle_loops;
+  m_recompiled = other.m_recompiled;
+
+  m_idle_loop = {};
+  m_blocks.leave();
+  return *this;
+}
+
+void CPU::idle() noexcept {
+  const std::uint64_t deadline = m_clock.deadline();
+  if(deadline == std::numeric_limits<std::uint64_t>::max())
+    m_clock.deadline(m_clock.data()); // nothing scheduled, leave the run so the caller can request an interrupt
+  else if(deadline > m_clock.data()) m_clock.cycle(deadline - m_clock.data());
+  // else already past it, e.g. halted right after an interrupt dispatch, nothing left to wait for
+}
+
+// an interrupt requested, even a disabled one (ime reset) ends the halt
+bool CPU::wake() noexcept {
+  if(m_bus.interruptHandler.isThereAnAwaitingInterrupt()) {
+    mode = mode_t::running;
+    return true;
+  }
 
-  ime = flag{};
+  idle();
+  return false;
 }
 
 // 8-bit Arithmetic and Logic Instructions
 void CPU::adc(const r8 r) noexcept { // adc A,r8 // // z 0 h c
-  const flag c = (A.data() + r.data() + F.c) > r8::max();
-  const flag h = (A.lowNibble() + r.lowNibble() + F.c) > 0b0000'1111;
-
-  A = A + r + F.c;
+  const flag c = carry();
+  addFlags(A.data(), r.data(), c);
 
-  F = {A == 0, 0, h, c};
+  A = A + r + c;
 
   m_clock.cycle(1);
 }
 
 void CPU::adc(const byte b) noexcept { // adc A,[HL] // z 0 h c
-  const flag c = (A.data() + b + F.c) > r8::max();
-  const flag h = (A.lowNibble() + (b & 0b0000'1111) + F.c) > 0b0000'1111;
+  const flag c = carry();
+  addFlags(A.data(), b, c);
 
-  A = A + b + F.c;
-
-  F = {A == 0, 0, h, c};
+  A = A + b + c;
 
   m_clock.cycle(2);
 }
 
 void CPU::adc(const n8 n) noexcept { // adc A,n8
-  const flag c = (A.data() + n.m_data + F.c) > r8::max();
-  const flag h = (A.lowNibble() + n.lowNibble() + F.c) > 0b0000'1111;
-
-  A = A + n + F.c;
+  const flag c = carry();
+  addFlags(A.data(), n.m_data, c);
 
-  F = {A == 0, 0, h, c};
+  A = A + n + c;
 
   m_clock.cycle(2);
 }
 
 void CPU::add(const r8 r) noexcept { // add A,r8 // // z 0 h c
-  const flag c = (A.data() + r.data()) > r8::max();
-  const flag h = (A.lowNibble() + r.lowNibble()) > 0b0000'1111;
+  addFlags(A.data(), r.data(), 0);
 
   A = A + r;
 
-  F = {A == 0, 0, h, c};
-
   m_clock.cycle(1);
 }
 
 void CPU::add(const byte b) noexcept { // add A,[HL] // z 0 h c
-  const flag c = (A.data() + b) > r8::max();
-  const flag h = (A.lowNibble() + (b & 0b0000'1111)) > 0b0000'1111;
+  addFlags(A.data(), b, 0);
 
   A = A + b;
 
-  F = {A == 0, 0, h, c};
-
   m_clock.cycle(2);
 }
 
 void CPU::add(const n8 n) noexcept { // add A,n8
-  const flag c = (A.data() + n.m_data) > r8::max();
-  const flag h = (A.lowNibble() + n.lowNibble()) > 0b0000'1111;
+  addFlags(A.data(), n.m_data, 0);
 
   A = A + n;
 
-  F = {A == 0, 0, h, c};
-
   m_clock.cycle(2);
 }
 
 void CPU::and_(const r8 r) noexcept { // and A,r8 // z 0 1 0
+  dropFlags();
   A &= r;
   F = {A == 0, 0, 1, 0};
 
@@ -795,6 +424,7 @@ void CPU::and_(const r8 r) noexcept { // and A,r8 // z 0 1 0
 }
 
 void CPU::and_(const byte b) noexcept { // and A,[HL]
+  dropFlags();
   A &= b;
   F = {A == 0, 0, 1, 0};
 
@@ -802,6 +432,7 @@ void CPU::and_(const byte b) noexcept { // and A,[HL]
 }
 
 void CPU::and_(const n8 n) noexcept { // and A,n8
+  dropFlags();
   A &= n;
   F = {A == 0, 0, 1, 0};
 
@@ -809,32 +440,33 @@ void CPU::and_(const n8 n) noexcept { // and A,n8
 }
 
 void CPU::cp(const r8 r) noexcept { // cp A,r8 // z 1 h c
-  F = {A == r, 1, r.lowNibble() > A.lowNibble(), r > A};
+  subFlags(A.data(), r.data(), 0);
 
   m_clock.cycle(1);
 }
 
 void CPU::cp(const byte b) noexcept { // cp A,[HL]
-  F = {A == b, 1, (b & 0b0000'1111) > A.lowNibble(), b > A};
+  subFlags(A.data(), b, 0);
 
   m_clock.cycle(2);
 }
 
 void CPU::cp(const n8 n) noexcept { // cp A,n8
-  F = {A == n, 1, n.lowNibble() > A.lowNibble(), n > A};
+  subFlags(A.data(), n.m_data, 0);
 
   m_clock.cycle(2);
 }
 
 void CPU::dec(r8 &r) noexcept { // dec r8 // z 1 h -
-  --r;
+  decFlags(r.data());
 
-  F = {r == 0, 1, r.lowNibble() == 0b0000'1111, F.c};
+  --r;
 
   m_clock.cycle(1);
 }
 
 void CPU::dec(byte b) noexcept { // dec [HL] // z 1 h -
+  settleFlags();
   --b;
   m_bus.write(HL.data(), b);
 
@@ -844,14 +476,15 @@ void CPU::dec(byte b) noexcept { // dec [HL] // z 1 h -
 }
 
 void CPU::inc(r8 &r) noexcept { // inc r8 // z 0 h -
-  ++r;
+  incFlags(r.data());
 
-  F = {r == 0, 0, r.lowNibble() == 0, F.c};
+  ++r;
 
   m_clock.cycle(1);
 }
 
 void CPU::inc(byte b) noexcept { // inc [HL]
+  settleFlags();
   ++b;
   m_bus.write(HL.data(), b);
 
@@ -861,6 +494,7 @@ void CPU::inc(byte b) noexcept { // inc [HL]
 }
 
 void CPU::or_(const r8 r) noexcept { // or A,r8 // z 0 0 0
+  dropFlags();
   A |= r;
   F = {A == 0, 0, 0, 0};
 
@@ -868,6 +502,7 @@ void CPU::or_(const r8 r) noexcept { // or A,r8 // z 0 0 0
 }
 
 void CPU::or_(const byte b) noexcept { // or A,[HL]
+  dropFlags();
   A |= b;
   F = {A == 0, 0, 0, 0};
 
@@ -875,6 +510,7 @@ void CPU::or_(const byte b) noexcept { // or A,[HL]
 }
 
 void CPU::or_(const n8 n) noexcept { // or A,n8
+  dropFlags();
   A |= n;
   F = {A == 0, 0, 0, 0};
 
@@ -882,59 +518,58 @@ void CPU::or_(const n8 n) noexcept { // or A,n8
 }
 
 void CPU::sbc(const r8 r) noexcept { // sbc A,r8 // z 1 h c
-                                     // A = A - r - F.c
-  const flag c = (r.data() + F.c) > A;
-  const flag h = (r.lowNibble() + F.c) > A.lowNibble();
+  const flag c = carry();
+  subFlags(A.data(), r.data(), c);
 
-  A = A - r - F.c;
-  F = {A == 0, 1, h, c};
+  A = A - r - c;
 
   m_clock.cycle(1);
 }
 
 void CPU::sbc(const byte b) noexcept { // sbc A,[HL]
-  const flag c = (b + F.c) > A;
-  const flag h = ((b & 0b0000'1111) + F.c) > A.lowNibble();
+  const flag c = carry();
+  subFlags(A.data(), b, c);
 
-  A = A - b - F.c;
-  F = {A == 0, 1, h, c};
+  A = A - b - c;
 
   m_clock.cycle(2);
 }
 
 void CPU::sbc(const n8 n) noexcept { // sbc A,n8
-  const flag c = (n.m_data + F.c) > A;
-  const flag h = ((n.m_data & 0b0000'1111) + F.c) > A.lowNibble();
+  const flag c = carry();
+  subFlags(A.data(), n.m_data, c);
 
-  A = A - n - F.c;
-  F = {A == 0, 1, h, c};
+  A = A - n - c;
 
   m_clock.cycle(2);
 }
 
 void CPU::sub(const r8 r) noexcept { // sub A,r8 // z 1 h c
-                                     // A = A - r
-  F = {A == r, 1, r.lowNibble() > A.lowNibble(), r > A};
+  subFlags(A.data(), r.data(), 0);
+
   A = A - r;
 
   m_clock.cycle(1);
 }
 
 void CPU::sub(const byte b) noexcept { // sub A,[HL]
-  F = {A == b, 1, (b & 0b0000'1111) > A.lowNibble(), b > A};
+  subFlags(A.data(), b, 0);
+
   A = A - b;
 
   m_clock.cycle(2);
 }
 
 void CPU::sub(const n8 n) noexcept { // sub A,n8
-  F = {A == n, 1, n.lowNibble() > A.lowNibble(), n > A};
+  subFlags(A.data(), n.m_data, 0);
+
   A = A - n;
 
   m_clock.cycle(2);
 }
 
 void CPU::xor_(const r8 r) noexcept { // xor A,r8 // z 0 0 0
+  dropFlags();
   A ^= r;
   F = {A == 0, 0, 0, 0};
 
@@ -942,6 +577,7 @@ void CPU::xor_(const r8 r) noexcept { // xor A,r8 // z 0 0 0
 }
 
 void CPU::xor_(const byte b) noexcept { // xor A,[HL]
+  dropFlags();
   A ^= b;
   F = {A == 0, 0, 0, 0};
 
@@ -949,6 +585,7 @@ void CPU::xor_(const byte b) noexcept { // xor A,[HL]
 }
 
 void CPU::xor_(const n8 n) noexcept { // xor A,n8
+  dropFlags();
   A ^= n;
   F = {A == 0, 0, 0, 0};
 
@@ -957,6 +594,7 @@ void CPU::xor_(const n8 n) noexcept { // xor A,n8
 
 // 16-bit Arithmetic Instructions
 void CPU::add(HL_register_tag_t, const r16 rr) noexcept { // add HL,r16  // - 0 h c
+  settleFlags();
   const flag c = (HL.data() + rr.data()) > r16::max();
   const flag h = ((HL.data() & 0x0fff) + (rr.data() & 0x0fff)) > 0x0fff;
 
@@ -981,12 +619,14 @@ void CPU::inc(r16 &rr) noexcept { // inc r16
 
 // Bit Operations Instructions
 void CPU::bit(const u3 u, const r8 r) noexcept { // bit u3,r8 // z 0 1 -
+  settleFlags();
   F = {bool(r.data() & byte(0b1 << u.m_data)) == 0, 0, 1, F.c};
 
   m_clock.cycle(2);
 }
 
 void CPU::bit(const u3 u, const byte b) noexcept { // bit u3,[HL] // z 0 1 -
+  settleFlags();
   F = {bool(b & byte(0b1 << u.m_data)) == 0, 0, 1, F.c};
 
   m_clock.cycle(3);
@@ -1023,6 +663,7 @@ void CPU::set(const u3 u, byte b) noexcept { // set u3,[HL]
 }
 
 void CPU::swap(r8 &r) noexcept { // swap r8 // z 0 0 0
+  dropFlags();
   r = byte((r.lowNibble() << 4) | r.highNibble());
   F = {r == 0, 0, 0, 0};
 
@@ -1030,6 +671,7 @@ void CPU::swap(r8 &r) noexcept { // swap r8 // z 0 0 0
 }
 
 void CPU::swap(byte b) noexcept { // swap [HL]
+  dropFlags();
   b = byte(((b & 0b000'1111) << 4) | ((b & 0b1111'0000) >> 4));
 
   m_bus.write(HL.data(), b);
@@ -1041,6 +683,7 @@ void CPU::swap(byte b) noexcept { // swap [HL]
 
 // Bit Shift Instructions
 void CPU::rl(r8 &r) noexcept { // rl r8 // z 0 0 c
+  settleFlags();
                                // C <- [7 <- 0] <- C
   const flag old_carry = F.c;
   F.c = 0b1000'0000 & r.data();
@@ -1053,6 +696,7 @@ void CPU::rl(r8 &r) noexcept { // rl r8 // z 0 0 c
 }
 
 void CPU::rl(byte b) noexcept { // rl [HL]
+  settleFlags();
   const flag old_carry = F.c;
   F.c = 0b1000'0000 & b;
 
@@ -1066,6 +710,7 @@ void CPU::rl(byte b) noexcept { // rl [HL]
 }
 
 void CPU::rla() noexcept { // rla // 0 0 0 c
+  settleFlags();
   const flag old_carry = F.c;
   F.c = 0b1000'0000 & A.data();
 
@@ -1078,6 +723,7 @@ void CPU::rla() noexcept { // rla // 0 0 0 c
 }
 
 void CPU::rlc(r8 &r) noexcept { // rlc r8 // z 0 0 c
+  settleFlags();
                                 // C <- [7 <- 0] <- [7]
   const flag old_7th_bit = r.data() & 0b1000'0000;
   F.c = old_7th_bit;
@@ -1091,6 +737,7 @@ void CPU::rlc(r8 &r) noexcept { // rlc r8 // z 0 0 c
 }
 
 void CPU::rlc(byte b) noexcept { // rlc [HL]
+  settleFlags();
   const flag old_7th_bit = b & 0b1000'0000;
   F.c = old_7th_bit;
 
@@ -1105,6 +752,7 @@ void CPU::rlc(byte b) noexcept { // rlc [HL]
 }
 
 void CPU::rlca() noexcept { // rlca // 0 0 0 c
+  settleFlags();
   const flag old_7th_bit = A.data() & 0b1000'0000;
   F.c = old_7th_bit;
 
@@ -1117,6 +765,7 @@ void CPU::rlca() noexcept { // rlca // 0 0 0 c
 }
 
 void CPU::rr(r8 &r) noexcept { // rr r8 // z 0 0 c
+  settleFlags();
                                // C -> [7 -> 0] -> C
   const flag old_carry = F.c;
   F.c = r.data() & 0b0000'0001;
@@ -1130,6 +779,7 @@ void CPU::rr(r8 &r) noexcept { // rr r8 // z 0 0 c
 }
 
 void CPU::rr(byte b) noexcept { // rr [HL]
+  settleFlags();
   const flag old_carry = F.c;
   F.c = b & 0b0000'0001;
 
@@ -1143,6 +793,7 @@ void CPU::rr(byte b) noexcept { // rr [HL]
 }
 
 void CPU::rra() noexcept { // rra // // 0 0 0 c
+  settleFlags();
   const flag old_carry = F.c;
   F.c = A.data() & 0b0000'0001;
 
@@ -1155,6 +806,7 @@ void CPU::rra() noexcept { // rra // // 0 0 0 c
 }
 
 void CPU::rrc(r8 &r) noexcept { // rrc r8 // z 0 0 c
+  dropFlags();
                                 // [0] -> [7 -> 0] -> C
   const bool carry = r.data() & 0b0000'0001;
   r >>= 1;
@@ -1166,6 +818,7 @@ void CPU::rrc(r8 &r) noexcept { // rrc r8 // z 0 0 c
 }
 
 void CPU::rrc(byte b) noexcept { // rrc [HL]
+  dropFlags();
   const bool carry = b & 0b0000'0001;
   b >>= 1;
   b |= (carry << 7);
@@ -1178,6 +831,7 @@ void CPU::rrc(byte b) noexcept { // rrc [HL]
 }
 
 void CPU::rrca() noexcept { // rrca // 0 0 0 c
+  dropFlags();
   const bool carry = A.data() & 0b0000'0001;
   A >>= 1;
   A |= (carry << 7);
@@ -1188,6 +842,7 @@ void CPU::rrca() noexcept { // rrca // 0 0 0 c
 }
 
 void CPU::sla(r8 &r) noexcept { // sla r8 // z 0 0 c
+  settleFlags();
                                 // C <- [7 <- 0] <- 0
   F.c = r.data() & 0b1000'0000;
   r <<= 1;
@@ -1198,6 +853,7 @@ void CPU::sla(r8 &r) noexcept { // sla r8 // z 0 0 c
 }
 
 void CPU::sla(byte b) noexcept { // sla [HL]
+  settleFlags();
   F.c = b & 0b1000'0000;
   b <<= 1;
 
@@ -1209,6 +865,7 @@ void CPU::sla(byte b) noexcept { // sla [HL]
 }
 
 void CPU::sra(r8 &r) noexcept { // sra r8 // z 0 0 c
+  settleFlags();
   const flag old_7th_bit = r.data() & 0b1000'0000;
   F.c = r.data() & 0b0000'0001;
 
@@ -1221,6 +878,7 @@ void CPU::sra(r8 &r) noexcept { // sra r8 // z 0 0 c
 }
 
 void CPU::sra(byte b) noexcept { // sra [HL]
+  settleFlags();
   const flag old_7th_bit = b & 0b1000'0000;
   F.c = b & 0b0000'0001;
 
@@ -1235,6 +893,7 @@ void CPU::sra(byte b) noexcept { // sra [HL]
 }
 
 void CPU::srl(r8 &r) noexcept { // srl r8 // z 0 0 c
+  settleFlags();
                                 // 0 -> [7 -> 0] -> C
   F.c = r.data() & 0b0000'0001;
   r >>= 1;
@@ -1245,6 +904,7 @@ void CPU::srl(r8 &r) noexcept { // srl r8 // z 0 0 c
 }
 
 void CPU::srl(byte b) noexcept { // srl [HL]
+  settleFlags();
   F.c = b & 0b0000'0001;
   b >>= 1;
 
@@ -1311,14 +971,14 @@ void CPU::ldh(memory_to_register_t, const byte b, C_register_tag_t) noexcept { /
 }
 
 void CPU::ld(memory_to_register_t, HLi_tag_t) noexcept { // ld A,[HLI]
-  A = *HL;
+  A = m_bus.read(HL.data());
   ++HL;
 
   m_clock.cycle(2);
 }
 
 void CPU::ld(memory_to_register_t, HLd_tag_t) noexcept { // ld A,[HLD]
-  A = *HL;
+  A = m_bus.read(HL.data());
   --HL;
 
   m_clock.cycle(2);
@@ -1350,6 +1010,7 @@ void CPU::call(const n16 nn) noexcept { // call n16
 }
 
 void CPU::call(const cc c, const n16 nn) noexcept {           // call cc,n16
+  settleFlags();
   if((c == cc::z && F.z == 1) || (c == cc::nz && F.z == 0) || //
      (c == cc::c && F.c == 1) || (c == cc::nc && F.c == 0)) {
 
@@ -1371,42 +1032,53 @@ void CPU::jp(HL_register_tag_t) noexcept { // jp HL
 }
 
 void CPU::jp(const n16 nn) noexcept { // jp n16
+  const address_t end = PC.m_data;
   PC = nn;
 
   m_clock.cycle(4);
+  if(PC.m_data < end) idleLoop(end);
 }
 
 void CPU::jp(const cc c, const n16 nn) noexcept {             // jp cc,n16
+  settleFlags();
   if((c == cc::z && F.z == 1) || (c == cc::nz && F.z == 0) || //
      (c == cc::c && F.c == 1) || (c == cc::nc && F.c == 0)) {
 
+    const address_t end = PC.m_data;
     PC = nn;
 
     m_clock.cycle(4);
+    if(PC.m_data < end) idleLoop(end);
   } else {
     m_clock.cycle(3);
   }
 }
 
 void CPU::jr(const e8 e) noexcept { // jr e8
+  const address_t end = PC.m_data;
   PC.m_data += e.m_data;
 
   m_clock.cycle(3);
+  if(e.m_data < 0) idleLoop(end);
 }
 
 void CPU::jr(const cc c, const e8 e) noexcept {               // jr cc,e8
+  settleFlags();
   if((c == cc::z && F.z == 1) || (c == cc::nz && F.z == 0) || //
      (c == cc::c && F.c == 1) || (c == cc::nc && F.c == 0)) {
 
+    const address_t end = PC.m_data;
     PC.m_data += e.m_data;
 
     m_clock.cycle(3);
+    if(e.m_data < 0) idleLoop(end);
   } else {
     m_clock.cycle(2);
   }
 }
 
 void CPU::ret(const cc c) noexcept {                          // ret cc
+  settleFlags();
   if((c == cc::z && F.z == 1) || (c == cc::nz && F.z == 0) || //
      (c == cc::c && F.c == 1) || (c == cc::nc && F.c == 0)) {
 
@@ -1445,6 +1117,7 @@ void CPU::rst(const std::uint16_t v) noexcept { // rst vec
 
 // // Stack Operations Instructions
 void CPU::add(HL_register_tag_t, SP_register_tag_t) noexcept { // add HL,SP // - 0 h c
+  settleFlags();
   const flag c = (HL.data() + SP.m_data) > r16::max();
   const flag h = ((HL.data() & 0x0fff) + (SP.m_data & 0x0fff)) > 0x0fff;
 
@@ -1456,6 +1129,7 @@ void CPU::add(HL_register_tag_t, SP_register_tag_t) noexcept { // add HL,SP // -
 }
 
 void CPU::add(SP_register_tag_t, const e8 e) noexcept { // add SP,e8 // 0 0 h c
+  dropFlags();
   const flag c = (SP.m_data & 0x00ff) + e.m_data > 0b1111'1111;
   const flag h = (SP.m_data & 0x000f) + e.m_data > 0b0000'1111;
 
@@ -1485,6 +1159,7 @@ void CPU::ld(SP_register_tag_t, const n16 nn) noexcept { // ld SP,n16
 }
 
 void CPU::ld(HL_register_tag_t, SP_register_tag_t, const e8 e) noexcept { // ld HL,SP+e8 // 0 0 h c
+  dropFlags();
   const flag c = ((SP.m_data & 0x00ff) + e.m_data) > 0b1111'1111;
   const flag h = ((SP.m_data & 0x000f) + e.m_data) > 0b0000'1111;
 
@@ -1504,6 +1179,7 @@ void CPU::ld(SP_register_tag_t, HL_register_tag_t) noexcept { // ld SP,HL
 }
 
 void CPU::pop(AF_register_tag_t) noexcept { // pop AF // z n h c
+  dropFlags();
   const byte f = m_bus.read(SP.m_data++);
   F.z = f & 0b1000'0000;
   F.n = f & 0b0100'0000;
@@ -1525,6 +1201,7 @@ void CPU::pop(r16 &rr) noexcept { // pop r16
 }
 
 void CPU::push(AF_register_tag_t) noexcept { // push AF
+  settleFlags();
   m_bus.write(--SP.m_data, A.data());
   m_bus.write(--SP.m_data, F.data());
 
@@ -1540,12 +1217,14 @@ void CPU::push(const r16 rr) noexcept { // push r16
 
 // // Miscellaneous Instructions
 void CPU::ccf() noexcept { // ccf // - 0 0 c
+  settleFlags();
   F = {F.z, 0, 0, bool(F.c ^ 1)};
 
   m_clock.cycle(1);
 }
 
 void CPU::cpl() noexcept { // cpl // - 1 1 -
+  settleFlags();
   A = ~A;
   F = {F.z, 1, 1, F.c};
 
@@ -1555,6 +1234,7 @@ void CPU::cpl() noexcept { // cpl // - 1 1 -
 // decimal adjusted addition (daa)
 // https://forums.nesdev.org/viewtopic.php?f=20&t=15944
 void CPU::daa() noexcept { // daa // z - 0 c
+  settleFlags();
   // clang-format off
   if(F.n) {
     if(F.c)                         { A -= 0x60;          }
@@ -1583,8 +1263,21 @@ void CPU::ei() noexcept { // ei
   m_clock.cycle(1);
 }
 
+// https://gbdev.io/pandocs/halt.html
 void CPU::halt() noexcept { // halt
-  /* implement this */
+  m_clock.cycle(1);
+
+  if(!m_bus.interruptHandler.isThereAnAwaitingInterrupt()) {
+    mode = mode_t::halted;
+    idle();
+    return;
+  }
+
+  if(ime) return; // doesn't halt, the interrupt is served right away
+
+  // The halt bug: the CPU doesn't halt and fails to increment PC after reading the next opcode, see fetchOpcode()
+  m_halt_bug = true;
+  m_blocks.leave();
 }
 
 void CPU::nop() noexcept { // nop
@@ -1592,6 +1285,7 @@ void CPU::nop() noexcept { // nop
 }
 
 void CPU::scf() noexcept { // scf - 0 0 1
+  settleFlags();
   F = {F.z, 0, 0, 1};
 
   m_clock.cycle(1);
@@ -3,9 +3,6 @@
 #include <LR35902/debugView/debugView.h>
 #include <LR35902/memory_map.h>
 
-#include <range/v3/view/chunk.hpp>
-#include <range/v3/view/subrange.hpp>
-
 #include <mpark/patterns/match.hpp>
 
 #include <GL/gl.h>
@@ -14,6 +11,8 @@
 #include <imgui.h>
 #include <imgui_memory_editor.h>
 
+#include <array>
+#include <cstddef>
 #include <utility>
 #include <variant>
 
@@ -31,6 +30,11 @@ DebugView::DebugView(const Emu &gameboy) :
 
   memory_editor.ReadOnly = true;
   memory_editor.PreviewDataType = ImGuiDataType_U8;
+  memory_editor.UserData = this;
+  memory_editor.WriteFn = [](ImU8 *data, std::size_t offset, ImU8 b, void *user_data) {
+    data[offset] = b;
+    static_cast<DebugView *>(user_data)->m_edited = offset;
+  };
 
   glCreateFramebuffers(1, &vram_fbo);
   glBindFramebuffer(GL_FRAMEBUFFER, vram_fbo);
@@ -69,6 +73,7 @@ void DebugView::showCartHeader() noexcept {
 
 void DebugView::showMemoryPortions() noexcept {
   im::Begin("Memory Portions", &_memory_portions);
+  m_edited.reset(); // each tab looks at the edits made to its own memory
 
   if(im::BeginTabBar("Tab Bar")) {
 
@@ -89,8 +94,9 @@ void DebugView::showMemoryPortions() noexcept {
     }
 
     if(im::BeginTabItem("vram", &_memory_portions_vram)) {
-      memory_editor.DrawContents(static_cast<void *>(const_cast<byte *>(std::data(emu.ppu.m_vram))),
-                                 std::size(emu.ppu.m_vram), mmap::vram);
+      memory_editor.DrawContents(static_cast<void *>(const_cast<byte *>(std::data(emu.machine.vram))),
+                                 std::size(emu.machine.vram), mmap::vram);
+      if(std::exchange(m_edited, std::nullopt)) const_cast<PPU &>(emu.ppu).invalidate(); // not through writeVRAM
       im::EndTabItem();
     }
 
@@ -113,18 +119,23 @@ void DebugView::showMemoryPortions() noexcept {
     if(im::BeginTabItem("wram", &_memory_portions_wram)) {
       memory_editor.DrawContents(static_cast<void *>(const_cast<byte *>(std::data(emu.builtIn.m_wram))),
                                  std::size(emu.builtIn.m_wram), mmap::wram0);
+      if(const auto offset = std::exchange(m_edited, std::nullopt))
+        const_cast<Bus &>(emu.bus).invalidate(mmap::wram0 + *offset); // the blocks decoded from it
       im::EndTabItem();
     }
 
     if(im::BeginTabItem("echo", &_memory_portions_echo)) {
       memory_editor.DrawContents(static_cast<void *>(const_cast<byte *>(std::data(emu.builtIn.m_echo))),
                                  std::size(emu.builtIn.m_echo), mmap::echo);
+      if(const auto offset = std::exchange(m_edited, std::nullopt))
+        const_cast<Bus &>(emu.bus).invalidate(mmap::echo + *offset);
       im::EndTabItem();
     }
 
     if(im::BeginTabItem("oam", &_memory_portions_oam)) {
-      memory_editor.DrawContents(static_cast<void *>(const_cast<byte *>(std::data(emu.ppu.m_oam))), std::size(emu.ppu.m_oam),
+      memory_editor.DrawContents(static_cast<void *>(const_cast<byte *>(std::data(emu.machine.oam))), std::size(emu.machine.oam),
                                  mmap::oam);
+      if(std::exchange(m_edited, std::nullopt)) const_cast<PPU &>(emu.ppu).invalidate(); // not through writeOAM
       im::EndTabItem();
     }
 
@@ -135,14 +146,15 @@ void DebugView::showMemoryPortions() noexcept {
     }
 
     if(im::BeginTabItem("io", &_memory_portions_io)) {
-      memory_editor.DrawContents(static_cast<void *>(const_cast<byte *>(std::data(emu.io.m_data))), std::size(emu.io.m_data),
-                                 mmap::io);
+      memory_editor.DrawContents(static_cast<void *>(const_cast<byte *>(emu.io.data())), IO::size, mmap::io);
       im::EndTabItem();
     }
 
     if(im::BeginTabItem("hram", &_memory_portions_hram)) {
       memory_editor.DrawContents(static_cast<void *>(const_cast<byte *>(std::data(emu.builtIn.m_hram))),
                                  std::size(emu.builtIn.m_hram), mmap::hram);
+      if(const auto offset = std::exchange(m_edited, std::nullopt))
+        const_cast<Bus &>(emu.bus).invalidate(mmap::hram + *offset);
       im::EndTabItem();
     }
 
@@ -185,6 +197,7 @@ void DebugView::showDisassembly() noexcept {
 
 void DebugView::showCPUState() noexcept {
   im::Begin("CPU State", &_cpu_state);
+  const_cast<CPU &>(emu.cpu).settleFlags(); // the flags of the last add or sub may not have been computed yet
   const auto &cpu = emu.cpu;
 
   const char *const state = cpu.mode == CPU::mode_t::running  ? "Running"
@@ -193,7 +206,8 @@ void DebugView::showCPUState() noexcept {
   im::Text("State: %s", state);
 
   im::NewLine();
-  im::Text("Cycles: %llu\nLatest: %llu", cpu.m_clock.m_data, emu.clock.m_latest);
+  im::Text("Cycles: %llu\nLatest: %llu", cpu.m_clock.data(), emu.clock.latest());
+  im::Text("Skipped in idle loops: %llu", static_cast<unsigned long long>(cpu.skippedCycles()));
 
   im::NewLine();
   im::Text("ime: %d", cpu.ime);
@@ -376,7 +390,7 @@ void DebugView::showRegisters() noexcept {
   }
 
   if(im::Checkbox("Interrupts", &showInterruptRegisters); showInterruptRegisters) {
-    const auto &IE = emu.intr._IE;
+    const auto &IE = emu.machine.IE;
     const auto &IF = emu.io.IF;
 
     im::Text("IME: %d ", emu.cpu.ime); // interrupt master enable
@@ -426,47 +440,30 @@ void DebugView::showVRAM() noexcept {
     std::uint8_t r, g, b, a;
   };
 
-  // clang-format off
-  const auto tile_data_view = ranges::subrange(emu.ppu.m_vram.begin(), emu.ppu.m_vram.begin() + PPU::tileset_size)
-                              | ranges::views::chunk(PPU::tileline_size)
-                              | ranges::views::chunk(PPU::tile_h)
-                              | ranges::views::chunk(PPU::max_tiles_on_screen_x);
-  // clang-format on
-
-  for(int tile_row_dy = 0; const auto &tile_row_view : tile_data_view) {
-    for(int tile_n = 0; const auto &tile_view : tile_row_view) {
-      for(int tileline_row_dy = 0; const auto &tileline_view : tile_view) {
-        const byte tileline_byte_lower = tileline_view[0];
-        const byte tileline_byte_upper = tileline_view[1];
-
-        std::array<rgba8, PPU::tile_w> temp;
-        for(std::uint8_t mask = 0b1000'0000; auto &pixel : temp) {
-          bool bit0 = bool(tileline_byte_lower & mask);
-          bool bit1 = bool(tileline_byte_upper & mask);
-          mask >>= 1;
-          byte index = (bit1 << 1) | bit0;
-          switch(index) {
-          case 0: pixel = rgba8{107, 166, 74, 255}; break;
-          case 1: pixel = rgba8{67, 122, 99, 255}; break;
-          case 2: pixel = rgba8{37, 89, 85, 255}; break;
-          case 3: pixel = rgba8{18, 66, 76, 255}; break;
-          }
-        }
-        glTextureSubImage2D(vram_texture,                                // texture object name
-                            0,                                           // mipmap level (0 is base)
-                            tile_n * PPU::tile_w,                        // x offset in texels
-                            tile_row_dy * PPU::tile_h + tileline_row_dy, // y offset in texels
-                            std::size(temp),                             // subimage width
-                            1,                                           // subimage height
-                            GL_RGBA,                                     // pixel data format (e.g. GL_RGBA)
-                            GL_UNSIGNED_BYTE,                            // data type (e.g. GL_UNSIGNED_BYTE)
-                            std::data(temp)                              // pointer (or buffer offset) to pixel data
-        );
-        ++tileline_row_dy;
-      }
-      ++tile_n;
-    }
-    ++tile_row_dy;
+  constexpr rgba8 colors[]{{107, 166, 74, 255}, {67, 122, 99, 255}, {37, 89, 85, 255}, {18, 66, 76, 255}};
+
+  // the tiles the PPU has decoded, only those that changed since the last time
+  PPU &ppu = const_cast<PPU &>(emu.ppu);
+  for(std::size_t n = 0; n < PPU::tiles; ++n) {
+    if(!ppu.m_changed_tiles.test(n)) continue;
+    ppu.m_changed_tiles.reset(n);
+
+    const auto &lines = ppu.tile(n).lines;
+
+    std::array<rgba8, PPU::tile_w * PPU::tile_h> temp;
+    for(std::size_t i = 0; i < std::size(temp); ++i)
+      temp[i] = colors[lines[i / PPU::tile_w][i % PPU::tile_w]];
+
+    glTextureSubImage2D(vram_texture,                                       // texture object name
+                        0,                                                  // mipmap level (0 is base)
+                        n % PPU::max_tiles_on_screen_x * PPU::tile_w,       // x offset in texels
+                        n / PPU::max_tiles_on_screen_x * PPU::tile_h,       // y offset in texels
+                        PPU::tile_w,                                        // subimage width
+                        PPU::tile_h,                                        // subimage height
+                        GL_RGBA,                                            // pixel data format (e.g. GL_RGBA)
+                        GL_UNSIGNED_BYTE,                                   // data type (e.g. GL_UNSIGNED_BYTE)
+                        std::data(temp)                                     // pointer (or buffer offset) to pixel data
+    );
   }
 
   im::Begin("VRAM tiledata");
@@ -6,7 +6,7 @@ namespace LR35902 {
 
 [[nodiscard]] byte IO::readIO(address_t index) const noexcept {
   index = normalize_index(index, mmap::io);
-  return m_data[index];
+  return data()[index];
 }
 
 void IO::writeIO(address_t index, const byte b) noexcept {
@@ -21,15 +21,19 @@ void IO::writeIO(address_t index, const byte b) noexcept {
     return;
   }
 
-  m_data[index] = b;
+  data()[index] = b;
 }
 
-auto IO::data() const noexcept -> decltype(m_data) {
-  return m_data;
+byte *IO::data() noexcept {
+  return reinterpret_cast<byte *>(this);
+}
+
+const byte *IO::data() const noexcept {
+  return reinterpret_cast<const byte *>(this);
 }
 
 void IO::reset() noexcept {
-  m_data.fill(byte{});
+  *this = IO{};
 }
 
 }
@@ -1,6 +1,7 @@
 #include <LR35902/interrupt/interrupt.h>
 #include <LR35902/io/io.h>
 #include <LR35902/joypad/joypad.h>
+#include <LR35902/state/state.h>
 
 namespace LR35902 {
 
@@ -8,8 +9,8 @@ namespace LR35902 {
 // link: http://www.codeslinger.co.uk/pages/projects/gameboy/joypad.html
 // link: https://archive.org/details/GameBoyProgManVer1.1/page/n23/mode/1up
 
-Joypad::Joypad(IO &io, Interrupt &intr) noexcept :
-    m_io{io},
+Joypad::Joypad(State &state, Interrupt &intr) noexcept :
+    m_state{state},
     m_intr{intr} {}
 
 // clang-format off
@@ -36,14 +37,14 @@ void Joypad::update(button btn, keystatus status) noexcept {
 
   const auto isPressed = [this] (const button btn) -> bool {
     switch(btn) {
-    case button::right:  return !(m_state & 0b0000'0001);
-    case button::left:   return !(m_state & 0b0000'0010);
-    case button::up:     return !(m_state & 0b0000'0100);
-    case button::down:   return !(m_state & 0b0000'1000);
-    case button::b:      return !(m_state & 0b0001'0000);
-    case button::a:      return !(m_state & 0b0010'0000);
-    case button::start:  return !(m_state & 0b0100'0000);
-    case button::select: return !(m_state & 0b1000'0000);
+    case button::right:  return !(m_state.buttons & 0b0000'0001);
+    case button::left:   return !(m_state.buttons & 0b0000'0010);
+    case button::up:     return !(m_state.buttons & 0b0000'0100);
+    case button::down:   return !(m_state.buttons & 0b0000'1000);
+    case button::b:      return !(m_state.buttons & 0b0001'0000);
+    case button::a:      return !(m_state.buttons & 0b0010'0000);
+    case button::start:  return !(m_state.buttons & 0b0100'0000);
+    case button::select: return !(m_state.buttons & 0b1000'0000);
     }
   };
 
@@ -56,18 +57,18 @@ void Joypad::update(button btn, keystatus status) noexcept {
 
     // clang-format off
     switch(btn) {
-    case button::right:  m_state &= 0b1111'1110; break;
-    case button::left:   m_state &= 0b1111'1101; break;
-    case button::up:     m_state &= 0b1111'1011; break;
-    case button::down:   m_state &= 0b1111'0111; break;
-    case button::b:      m_state &= 0b1110'1111; break;
-    case button::a:      m_state &= 0b1101'1111; break;
-    case button::start:  m_state &= 0b1011'1111; break;
-    case button::select: m_state &= 0b0111'1111; break;
+    case button::right:  m_state.buttons &= 0b1111'1110; break;
+    case button::left:   m_state.buttons &= 0b1111'1101; break;
+    case button::up:     m_state.buttons &= 0b1111'1011; break;
+    case button::down:   m_state.buttons &= 0b1111'0111; break;
+    case button::b:      m_state.buttons &= 0b1110'1111; break;
+    case button::a:      m_state.buttons &= 0b1101'1111; break;
+    case button::start:  m_state.buttons &= 0b1011'1111; break;
+    case button::select: m_state.buttons &= 0b0111'1111; break;
     }
 
-    const bool expectingDirectionPress = !(m_io.P1 & 0b0001'0000);
-    const bool expectingSelectionPress = !(m_io.P1 & 0b0010'0000);
+    const bool expectingDirectionPress = !(m_state.io.P1 & 0b0001'0000);
+    const bool expectingSelectionPress = !(m_state.io.P1 & 0b0010'0000);
 
     if(isInterruptRequired)
       if((isDirectionButton(btn) && expectingDirectionPress) ||
@@ -79,39 +80,39 @@ void Joypad::update(button btn, keystatus status) noexcept {
     // clang-format off
   case keystatus::released: {
     switch(btn) {
-    case button::right:  m_state |= 0b0000'0001; break;
-    case button::left:   m_state |= 0b0000'0010; break;
-    case button::up:     m_state |= 0b0000'0100; break;
-    case button::down:   m_state |= 0b0000'1000; break;
-    case button::b:      m_state |= 0b0001'0000; break;
-    case button::a:      m_state |= 0b0010'0000; break;
-    case button::start:  m_state |= 0b0100'0000; break;
-    case button::select: m_state |= 0b1000'0000; break;
+    case button::right:  m_state.buttons |= 0b0000'0001; break;
+    case button::left:   m_state.buttons |= 0b0000'0010; break;
+    case button::up:     m_state.buttons |= 0b0000'0100; break;
+    case button::down:   m_state.buttons |= 0b0000'1000; break;
+    case button::b:      m_state.buttons |= 0b0001'0000; break;
+    case button::a:      m_state.buttons |= 0b0010'0000; break;
+    case button::start:  m_state.buttons |= 0b0100'0000; break;
+    case button::select: m_state.buttons |= 0b1000'0000; break;
     }
   } break;
   }
 }
 
 byte Joypad::read() const noexcept {
-  byte result = m_io.P1 ^ 0xff;
+  byte result = m_state.io.P1 ^ 0xff;
 
-  const bool expectingDirectionPress = !(m_io.P1 & 0b0001'0000);
+  const bool expectingDirectionPress = !(m_state.io.P1 & 0b0001'0000);
 
   if(expectingDirectionPress) {
-    const byte topJoypad = ((m_state & 0xf0) >> 4) | 0xf0;
+    const byte topJoypad = ((m_state.buttons & 0xf0) >> 4) | 0xf0;
     result &= topJoypad;
     return result;
   }
 
   else { 
-    const byte bottomJoypad = (m_state & 0x0f) | 0xf0;
+    const byte bottomJoypad = (m_state.buttons & 0x0f) | 0xf0;
     result &= bottomJoypad;
     return result;
   }
 }
 
 bool Joypad::isBlocked() const noexcept {
-  return (m_io.P1 & 0b1100'0000) == 0b1100'0000;
+  return (m_state.io.P1 & 0b1100'0000) == 0b1100'0000;
 }
 
 }
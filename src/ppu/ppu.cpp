@@ -3,30 +3,18 @@
 #include <LR35902/io/io.h>
 #include <LR35902/memory_map.h>
 #include <LR35902/ppu/ppu.h>
-
-#include <range/v3/action/reverse.hpp>
-#include <range/v3/action/sort.hpp>
-#include <range/v3/action/take.hpp>
-#include <range/v3/action/transform.hpp>
-#include <range/v3/algorithm/copy_n.hpp>
-#include <range/v3/algorithm/fill.hpp>
-#include <range/v3/algorithm/rotate.hpp>
-#include <range/v3/functional/comparisons.hpp>
-#include <range/v3/range/conversion.hpp>
-#include <range/v3/view/chunk.hpp>
-#include <range/v3/view/const.hpp>
-#include <range/v3/view/counted.hpp>
-#include <range/v3/view/filter.hpp>
-#include <range/v3/view/iota.hpp>
-#include <range/v3/view/join.hpp>
-#include <range/v3/view/remove_if.hpp>
-#include <range/v3/view/reverse.hpp>
-#include <range/v3/view/transform.hpp>
+#include <LR35902/ppu/tileline.h>
+#include <LR35902/state/state.h>
 
 #include <mpark/patterns/match.hpp>
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <bitset>
 #include <cstddef>
-#include <vector>
+#include <cstdint>
+#include <optional>
 
 #ifdef __clang__
   #pragma GCC diagnostic push
@@ -35,37 +23,60 @@
 
 namespace LR35902 {
 
-namespace rg = ranges;
-namespace rv = rg::views;
-namespace ra = rg::actions;
 namespace mp = mpark::patterns;
 
-PPU::PPU(Interrupt &intr, IO &io) noexcept :
+PPU::PPU(Interrupt &intr, State &state) noexcept :
     intr{intr},
-    io{io} {}
+    m_state{state} {
+  invalidate();
+}
+
+PPU &PPU::operator=(const PPU &other) noexcept {
+  m_framebuffer = other.m_framebuffer;
+#if defined(WITH_DEBUGGER)
+  m_background_framebuffer = other.m_background_framebuffer;
+  m_window_framebuffer = other.m_window_framebuffer;
+  m_sprites_framebuffer = other.m_sprites_framebuffer;
+#endif
+  invalidate(); // VRAM and OAM came along with the State
+  return *this;
+}
 
 byte PPU::readVRAM(address_t index) const noexcept {
   index = normalize_index(index, mmap::vram);
-  if(isVRAMAccessibleToCPU()) return m_vram[index];
+  if(isVRAMAccessibleToCPU()) return m_state.vram[index];
   return 0xff;
 }
 
 void PPU::writeVRAM(address_t index, const byte b) noexcept {
-  is_vram_changed = true;
   index = normalize_index(index, mmap::vram);
-  if(isVRAMAccessibleToCPU()) m_vram[index] = b;
+  if(!isVRAMAccessibleToCPU()) return;
+
+  if(index < tileset_size && m_state.vram[index] != b) {
+    m_dirty_tiles.set(index / tile_size);
+#if defined(WITH_DEBUGGER)
+    m_changed_tiles.set(index / tile_size);
+#endif
+  }
+  m_state.vram[index] = b;
 }
 
 byte PPU::readOAM(address_t index) const noexcept {
   index = normalize_index(index, mmap::oam);
-  if(isOAMAccessibleToCPU()) return m_oam[index];
+  if(isOAMAccessibleToCPU()) return m_state.oam[index];
   return 0xff;
 }
 
 void PPU::writeOAM(address_t index, const byte b) noexcept {
-  is_oam_changed = true;
   index = normalize_index(index, mmap::oam);
-  if(isOAMAccessibleToCPU()) m_oam[index] = b;
+  if(!isOAMAccessibleToCPU()) return;
+
+  const std::size_t sprite = index / sprite_size;
+  const bool moves = index % sprite_size == 0; // its y
+
+  if(moves) indexSprite(sprite, false);
+  m_state.oam[index] = b;
+  if(moves) indexSprite(sprite, true);
 }
 
 enum class PPU::source : std::uint8_t { hblank, vblank, oam, coincidence };
@@ -110,83 +121,108 @@ constexpr std::size_t vblank_end = vblank_start + vblank_height;
    LY = 0
 */
 
-static std::size_t ppu_cycles = 0;
 void PPU::update(const std::size_t cycles) noexcept {
-  ppu_cycles += cycles;
+  m_state.ppu_cycles += cycles;
 
   if(!isLCDEnabled()) { // LCD is off
-    ppu_cycles = 0;
+    m_state.ppu_cycles = 0;
     resetScanline();
     return;
   }
 
-  coincidence(checkCoincidence());
-  if(checkCoincidence() && interruptSourceEnabled(source::coincidence)) intr.request(Interrupt::kind::lcd_stat);
+  // a catch-up may span several modes, each transition takes its period off the cycles left and the next mode goes on
+  // with the rest
+  for(bool transitioned = true; transitioned;) {
+    transitioned = false;
 
-  switch(mode()) {
-  case state::searching:
-    if(ppu_cycles >= oam_search_period) {
-      ppu_cycles %= oam_search_period;
+    coincidence(checkCoincidence());
+    if(checkCoincidence() && interruptSourceEnabled(source::coincidence)) intr.request(Interrupt::kind::lcd_stat);
 
-      if(isBackgroundEnabled()) fetchBackground();
-      if(isWindowEnabled()) fetchWindow();
-      if(isSpritesEnabled()) fetchSprites();
+    switch(mode()) {
+    case state::searching:
+      if(m_state.ppu_cycles >= oam_search_period) {
+        m_state.ppu_cycles -= oam_search_period;
+        transitioned = true;
 
-      mode(state::drawing);
-    }
-    break;
+        updatePalettes();
+        if(isBackgroundEnabled()) fetchBackground();
+        if(isWindowEnabled()) fetchWindow();
+        if(isSpritesEnabled()) fetchSprites();
 
-  case state::drawing:
-    if(ppu_cycles >= draw_period) {
-      ppu_cycles %= draw_period;
+        mode(state::drawing);
+      }
+      break;
 
-      mode(state::hblanking);
+    case state::drawing:
+      if(m_state.ppu_cycles >= draw_period) {
+        m_state.ppu_cycles -= draw_period;
+        transitioned = true;
 
-      if(interruptSourceEnabled(source::hblank)) //
-        intr.request(Interrupt::kind::lcd_stat);
-    }
-    break;
+        mode(state::hblanking);
 
-  case state::hblanking:
-    if(ppu_cycles >= hblank_period) {
-      ppu_cycles %= hblank_period;
+        if(interruptSourceEnabled(source::hblank)) //
+          intr.request(Interrupt::kind::lcd_stat);
+      }
+      break;
 
-      updateScanline();
+    case state::hblanking:
+      if(m_state.ppu_cycles >= hblank_period) {
+        m_state.ppu_cycles -= hblank_period;
+        transitioned = true;
 
-      if(currentScanline() == vblank_start) {
-        mode(state::vblanking);
+        updateScanline();
 
-        intr.request(Interrupt::kind::vblank);
-      } else {
-        mode(state::searching);
+        if(currentScanline() == vblank_start) {
+          mode(state::vblanking);
 
-        if(interruptSourceEnabled(source::oam)) //
-          intr.request(Interrupt::kind::lcd_stat);
+          intr.request(Interrupt::kind::vblank);
+        } else {
+          mode(state::searching);
+
+          if(interruptSourceEnabled(source::oam)) //
+            intr.request(Interrupt::kind::lcd_stat);
+        }
       }
-    }
-    break;
+      break;
 
-  case state::vblanking:
-    if(ppu_cycles >= scanline_period) {
-      ppu_cycles %= scanline_period;
-      updateScanline();
+    case state::vblanking:
+      if(m_state.ppu_cycles >= scanline_period) {
+        m_state.ppu_cycles -= scanline_period;
+        transitioned = true;
+        updateScanline();
 
-      coincidence(checkCoincidence());
-      if(checkCoincidence() && interruptSourceEnabled(source::coincidence)) intr.request(Interrupt::kind::lcd_stat);
+        coincidence(checkCoincidence());
+        if(checkCoincidence() && interruptSourceEnabled(source::coincidence)) intr.request(Interrupt::kind::lcd_stat);
 
-      if(currentScanline() >= vblank_end) {
-        resetScanline();
+        if(currentScanline() >= vblank_end) {
+          resetScanline();
 
-        mode(state::searching);
+          mode(state::searching);
 
-        if(interruptSourceEnabled(source::oam)) //
-          intr.request(Interrupt::kind::lcd_stat);
+          if(interruptSourceEnabled(source::oam)) //
+            intr.request(Interrupt::kind::lcd_stat);
+        }
       }
+      break;
     }
-    break;
   }
 }
 
+std::optional<std::size_t> PPU::nextEvent() const noexcept {
+  if(!isLCDEnabled()) return std::nullopt;
+
+  const std::size_t period = [&] {
+    switch(mode()) {
+    case state::searching: return oam_search_period;
+    case state::drawing: return draw_period;
+    case state::hblanking: return hblank_period;
+    case state::vblanking: return scanline_period;
+    }
+  }();
+
+  return period > m_state.ppu_cycles ? period - m_state.ppu_cycles : 0;
+}
+
 auto PPU::getFrameBuffer() noexcept -> const framebuffer_t & {
   return m_framebuffer;
 }
@@ -208,21 +244,23 @@ auto PPU::getSpritesFrame() noexcept -> const framebuffer_t & {
 #endif
 
 void PPU::reset() noexcept {
-  rg::fill(m_vram, byte{});
-  rg::fill(m_oam, byte{});
-  rg::fill(m_framebuffer, palette_index_t{});
+  std::ranges::fill(m_state.vram, byte{});
+  std::ranges::fill(m_state.oam, byte{});
+  std::ranges::fill(m_framebuffer, palette_index_t{});
+  m_state.ppu_cycles = 0;
+  invalidate();
 
 #if defined(WITH_DEBUGGER)
-  rg::fill(m_background_framebuffer, palette_index_t{});
-  rg::fill(m_window_framebuffer, palette_index_t{});
-  rg::fill(m_sprites_framebuffer, palette_index_t{});
+  std::ranges::fill(m_background_framebuffer, palette_index_t{});
+  std::ranges::fill(m_window_framebuffer, palette_index_t{});
+  std::ranges::fill(m_sprites_framebuffer, palette_index_t{});
 #endif
 }
 
 PPU::state PPU::mode() const noexcept { // bit0, bit1
   using namespace mp;
 
-  return match(io.STAT & 0b0000'0011)(
+  return match(m_state.io.STAT & 0b0000'0011)(
       pattern(0b00) = [] { return state::hblanking; }, //
       pattern(0b01) = [] { return state::vblanking; }, //
       pattern(0b10) = [] { return state::searching; }, //
@@ -231,41 +269,41 @@ PPU::state PPU::mode() const noexcept { // bit0, bit1
 
 // LCDC register related members
 bool PPU::isLCDEnabled() const noexcept { // bit7
-  return io.LCDC & 0b1000'0000;
+  return m_state.io.LCDC & 0b1000'0000;
 }
 
 std::size_t PPU::windowTilemapBaseAddress() const noexcept { // bit6
-  return (io.LCDC & 0b0100'0000) ? 0x1C00 : 0x1800;
+  return (m_state.io.LCDC & 0b0100'0000) ? 0x1C00 : 0x1800;
 }
 
 bool PPU::isWindowEnabled() const noexcept { // bit5
-  return io.LCDC & 0b0010'0000;
+  return m_state.io.LCDC & 0b0010'0000;
 }
 
 std::size_t PPU::backgroundTilesetBaseAddress() const noexcept { // bit4
-  return (io.LCDC & 0b0001'0000) ? 0x0000 : 0x0800;
+  return (m_state.io.LCDC & 0b0001'0000) ? 0x0000 : 0x0800;
 }
 
 // window and background share the same memory space, so this member does the
 // same thing above
 std::size_t PPU::windowTilesetBaseAddress() const noexcept { // bit4
-  return (io.LCDC & 0b0001'0000) ? 0x0000 : 0x0800;
+  return (m_state.io.LCDC & 0b0001'0000) ? 0x0000 : 0x0800;
 }
 
 std::size_t PPU::backgroundTilemapBaseAddress() const noexcept { // bit3
-  return (io.LCDC & 0b0000'1000) ? 0x1C00 : 0x1800;
+  return (m_state.io.LCDC & 0b0000'1000) ? 0x1C00 : 0x1800;
 }
 
 bool PPU::isBigSprite() const noexcept { // bit2
-  return io.LCDC & 0b0000'0100;
+  return m_state.io.LCDC & 0b0000'0100;
 }
 
 bool PPU::isSpritesEnabled() const noexcept { // bit1
-  return io.LCDC & 0b0000'0010;
+  return m_state.io.LCDC & 0b0000'0010;
 }
 
 bool PPU::isBackgroundEnabled() const noexcept { // bit0
-  return io.LCDC & 0b0000'0001;
+  return m_state.io.LCDC & 0b0000'0001;
 }
 
 // STAT register related members
@@ -274,81 +312,71 @@ bool PPU::isBackgroundEnabled() const noexcept { // bit0
 void PPU::mode(const state s) noexcept { // bit0, bit1
   using namespace mp;
   match(s) (
-    pattern(state::hblanking) = [&] {  io.STAT &= 0b1111'1100;          },
-    pattern(state::vblanking) = [&] { (io.STAT &= 0b1111'1100) |= 0b01; },
-    pattern(state::searching) = [&] { (io.STAT &= 0b1111'1100) |= 0b10; },
-    pattern(state::drawing)   = [&] {  io.STAT |= 0b0000'0011;          }
+    pattern(state::hblanking) = [&] {  m_state.io.STAT &= 0b1111'1100;          },
+    pattern(state::vblanking) = [&] { (m_state.io.STAT &= 0b1111'1100) |= 0b01; },
+    pattern(state::searching) = [&] { (m_state.io.STAT &= 0b1111'1100) |= 0b10; },
+    pattern(state::drawing)   = [&] {  m_state.io.STAT |= 0b0000'0011;          }
   );
 }
 
 void PPU::coincidence(const bool b) noexcept {
-  if(b) io.STAT |= 0b0000'0100;
-  else  io.STAT &= 0b1111'1011;
+  if(b) m_state.io.STAT |= 0b0000'0100;
+  else  m_state.io.STAT &= 0b1111'1011;
 }
 
 bool PPU::interruptSourceEnabled(const source s) const noexcept {
   using namespace mp;
   return match(s) (
-    pattern(source::hblank) = [&] { return io.STAT & 0b0000'1000; }, // bit 3
-    pattern(source::vblank) = [&] { return io.STAT & 0b0001'0000; }, // bit 4
-    pattern(source::oam)    = [&] { return io.STAT & 0b0010'0000; }, // bit 5
-    pattern(source::coincidence) = [&] { return io.STAT & 0b0100'0000; }  // bit 6
+    pattern(source::hblank) = [&] { return m_state.io.STAT & 0b0000'1000; }, // bit 3
+    pattern(source::vblank) = [&] { return m_state.io.STAT & 0b0001'0000; }, // bit 4
+    pattern(source::oam)    = [&] { return m_state.io.STAT & 0b0010'0000; }, // bit 5
+    pattern(source::coincidence) = [&] { return m_state.io.STAT & 0b0100'0000; }  // bit 6
   );
 }
 // clang-format on
 
 // LY/LYC registers related members
 byte PPU::currentScanline() const noexcept {
-  return io.LY;
+  return m_state.io.LY;
 }
 
 void PPU::updateScanline() noexcept {
-  ++io.LY;
+  ++m_state.io.LY;
 }
 
 void PPU::resetScanline() noexcept {
-  io.LY = 0;
+  m_state.io.LY = 0;
 }
 
 bool PPU::checkCoincidence() const noexcept {
-  return io.LYC == io.LY;
+  return m_state.io.LYC == m_state.io.LY;
 }
 
 // BGP/OBP0/OBP1 palette registers related members
-std::array<PPU::palette_index_t, 4> PPU::bgp() const noexcept {
-  const palette_index_t pal_0 = io.BGP & 0b0000'0011;
-  const palette_index_t pal_1 = (io.BGP & 0b0000'1100) >> 2;
-  const palette_index_t pal_2 = (io.BGP & 0b0011'0000) >> 4;
-  const palette_index_t pal_3 = (io.BGP & 0b1100'0000) >> 6;
 
-  return {pal_0, pal_1, pal_2, pal_3};
-}
-
-std::array<PPU::palette_index_t, 4> PPU::obp0() const noexcept {
-  const palette_index_t pal_0 = io.OBP0 & 0b0000'0011;
-  const palette_index_t pal_1 = (io.OBP0 & 0b0000'1100) >> 2;
-  const palette_index_t pal_2 = (io.OBP0 & 0b0011'0000) >> 4;
-  const palette_index_t pal_3 = (io.OBP0 & 0b1100'0000) >> 6;
-
-  return {pal_0, pal_1, pal_2, pal_3};
-}
+// The registers are written through the bus, which doesn't tell the PPU. They're compared once a scanline instead, and
+// the colors only rebuilt when one changed.
+void PPU::updatePalettes() noexcept {
+  const auto update = [](palette_t &palette, const byte reg) {
+    if(palette.reg == reg) return;
 
-std::array<PPU::palette_index_t, 4> PPU::obp1() const noexcept {
-  const palette_index_t pal_0 = io.OBP1 & 0b0000'0011;
-  const palette_index_t pal_1 = (io.OBP1 & 0b0000'1100) >> 2;
-  const palette_index_t pal_2 = (io.OBP1 & 0b0011'0000) >> 4;
-  const palette_index_t pal_3 = (io.OBP1 & 0b1100'0000) >> 6;
+    palette.reg = reg;
+    for(std::size_t index = 0; index < palette.colors.size(); ++index)
+      palette.colors[index] = (reg >> (index * 2)) & 0b11;
+  };
 
-  return {pal_0, pal_1, pal_2, pal_3};
+  update(m_bgp, m_state.io.BGP);
+  update(m_obp0, m_state.io.OBP0);
+  update(m_obp1, m_state.io.OBP1);
 }
 
 // WY/WX palette registers related members
 int PPU::window_y() const noexcept {
-  return io.WY;
+  return m_state.io.WY;
 }
 
 int PPU::window_x() const noexcept {
-  return io.WX - 7;
+  return m_state.io.WX - 7;
 }
 
 /*
@@ -370,92 +398,68 @@ bool PPU::isOAMAccessibleToCPU() const noexcept {
   return mode() == state::hblanking || mode() == state::vblanking;
 }
 
-std::array<PPU::palette_index_t, PPU::tile_w> PPU::decodeTilelinePaletteIndices(byte tileline_byte_lower,
-                                                                                byte tileline_byte_upper) {
-  const std::uint16_t hash = (tileline_byte_upper << 8) | tileline_byte_lower;
-
-  if(tileline_cache.contains(hash)) // hit?
-    return tileline_cache[hash];
-
-  else {
-    std::array<PPU::palette_index_t, PPU::tile_w> temp;
-    for(std::uint8_t mask = 0b1000'0000; auto &e : temp) {
-      bool bit0 = bool(tileline_byte_lower & mask);
-      bool bit1 = bool(tileline_byte_upper & mask);
-      e = (bit1 << 1) | bit0;
-      mask >>= 1;
-    }
+const PPU::decoded_tile_t &PPU::tile(const std::size_t n) noexcept {
+  decoded_tile_t &decoded = m_tiles[n];
+  if(!m_dirty_tiles.test(n)) return decoded;
 
-    tileline_cache[hash] = temp;
-    return temp;
+  m_dirty_tiles.reset(n);
+  const byte *const data = m_state.vram.data() + n * tile_size;
+  for(std::size_t line = 0; line < tile_h; ++line) {
+    decoded.lines[line] = decodeTileline(data[line * tileline_size], data[line * tileline_size + 1]);
+    decoded.xflipped[line] = decoded.lines[line];
+    std::ranges::reverse(decoded.xflipped[line]);
   }
+  return decoded;
 }
 
-void PPU::fetchBackground() {
-  if(is_vram_changed) {
-    is_vram_changed = false;
-
-    tileset_view = rv::counted(m_vram.begin() + backgroundTilesetBaseAddress(), tileset_block_size) //
-                   | rv::chunk(tileline_size)                                                       //
-                   | rv::chunk(tile_h);
-
-    tilemap_view = rv::counted(m_vram.begin() + backgroundTilemapBaseAddress(), tilemap_block_size) //
-                   | rv::chunk(max_tiles_on_screen_x);
-  }
+void PPU::invalidate() noexcept {
+  m_dirty_tiles.set();
+#if defined(WITH_DEBUGGER)
+  m_changed_tiles.set();
+#endif
+  indexSprites();
+}
 
-  std::array<palette_index_t, screen_w> buffer;
+void PPU::fetchBackground() noexcept {
+  const std::size_t dy = (m_state.io.SCY + m_state.io.LY) % screen_h;
+  const byte *const tilemap_row =
+      m_state.vram.data() + backgroundTilemapBaseAddress() + dy / tile_h * max_tiles_on_screen_x;
+  const std::size_t tileset = backgroundTilesetBaseAddress() / tile_size;
+  const std::size_t tileline = dy % tile_h;
 
-  const std::size_t dy = (io.SCY + io.LY) % screen_h;
-  const std::size_t row = dy / tile_h;
-  const std::size_t currently_scannline_tileline = dy % tile_h;
+  palette_index_t *const line = m_framebuffer.data() + m_state.io.LY * viewport_w;
 
-  for(const std::size_t tile_nth : rv::iota(std::size_t{0}, max_tiles_on_screen_x)) {
-    const byte index = tilemap_view[row][tile_nth];
-    const auto tileline = tileset_view[index][currently_scannline_tileline];
-    const auto decoded = decodeTilelinePaletteIndices(tileline[0], tileline[1]);
+  // the 160 pixels from SCX on, wrapping around the 256 of the background
+  for(std::size_t x = 0, dx = m_state.io.SCX; x < viewport_w;) {
+    const tileline_t &decoded = tile(tileset + tilemap_row[dx / tile_w % max_tiles_on_screen_x]).lines[tileline];
 
-    for(const std::size_t i : rv::iota(std::size_t{0}, tile_w)) {
-      buffer[tile_nth * tile_w + i] = bgp()[decoded[i]];
-    }
+    for(std::size_t px = dx % tile_w; px < tile_w && x < viewport_w; ++px, ++x, ++dx)
+      line[x] = m_bgp.colors[decoded[px]];
   }
 
-  rg::rotate(buffer.begin(), buffer.begin() + io.SCX, buffer.end());
-  rg::copy_n(buffer.cbegin(), viewport_w, m_framebuffer.begin() + io.LY * viewport_w);
 #if defined(WITH_DEBUGGER)
-  rg::copy_n(buffer.cbegin(), viewport_w, m_background_framebuffer.begin() + io.LY * viewport_w);
+  std::copy_n(line, viewport_w, m_background_framebuffer.data() + m_state.io.LY * viewport_w);
 #endif
 }
 
-void PPU::fetchWindow() {
+void PPU::fetchWindow() noexcept {
   if(currentScanline() < window_y()) return;
 
-  if(is_vram_changed) {
-    is_vram_changed = false;
-
-    tileset_view = rv::counted(m_vram.begin() + windowTilesetBaseAddress(), tileset_block_size) //
-                   | rv::chunk(tileline_size)                                                   //
-                   | rv::chunk(tile_h);                                                         //
-
-    tilemap_view = rv::counted(m_vram.begin() + windowTilemapBaseAddress(), tilemap_block_size) //
-                   | rv::chunk(max_tiles_on_screen_x);
-  }
-
   const std::size_t row = currentScanline() / tile_h;
-  const std::size_t currently_scanning_tileline = currentScanline() % tile_h;
   const std::size_t window_x_ = (window_x() < 0) ? 0 : window_x();
+  const byte *const tilemap_row = m_state.vram.data() + windowTilemapBaseAddress() + row * max_tiles_on_screen_x;
+  const std::size_t tileset = windowTilesetBaseAddress() / tile_size;
+  const std::size_t tileline = currentScanline() % tile_h;
 
-  if(std::size_t{window_x_ / tile_w} > max_tiles_on_viewport_x) return; // REVISIT: fix what creates this case
+  palette_index_t *const line = m_framebuffer.data() + m_state.io.LY * viewport_w;
 
-  for(const std::size_t tile_nth : rv::iota(std::size_t{window_x_ / tile_w}, max_tiles_on_viewport_x)) {
-    const std::size_t tile_index = tilemap_view[row][tile_nth];
-    const auto tileline = tileset_view[tile_index][currently_scanning_tileline];
-    const auto decoded = decodeTilelinePaletteIndices(tileline[0], tileline[1]);
+  for(std::size_t x = window_x_ / tile_w * tile_w; x < viewport_w; x += tile_w) {
+    const tileline_t &decoded = tile(tileset + tilemap_row[x / tile_w]).lines[tileline];
 
-    for(const std::size_t i : rv::iota(std::size_t{0}, tile_w)) {
-      const std::size_t x = (tile_nth * tile_w) + i;
-      m_framebuffer[io.LY * viewport_w + x] = bgp()[decoded[i]];
+    for(std::size_t px = 0; px < tile_w; ++px) {
+      line[x + px] = m_bgp.colors[decoded[px]];
 #if defined(WITH_DEBUGGER)
-      m_window_framebuffer[io.LY * viewport_w + x] = bgp()[decoded[i]];
+      m_window_framebuffer[m_state.io.LY * viewport_w + x + px] = m_bgp.colors[decoded[px]];
 #endif
     }
   }
@@ -486,51 +490,64 @@ void PPU::fetchWindow() {
 0xff, 0x00,      ▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓   |   0xff, 0x00   ▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓▓
 */
 
-void PPU::fetchSprites() {
-  constexpr int sprite_viewport_offset_y = 16;
-  constexpr int sprite_viewport_offset_x = 8; // when a sprite is on (8, 16), it appears on top-left
+constexpr int sprite_viewport_offset_y = 16;
+constexpr int sprite_viewport_offset_x = 8; // when a sprite is on (8, 16), it appears on top-left
 
-  constexpr int sprite_starts_visible_x = 1;
-  constexpr int sprite_ends_visible_x = 168;
+constexpr int sprite_starts_visible_x = 1;
+constexpr int sprite_ends_visible_x = 168;
 
-  constexpr int sprite_starts_visible_y = 9;
-  constexpr int sprite_ends_visible_y = 160;
+constexpr int sprite_starts_visible_y = 9;
+constexpr int sprite_ends_visible_y = 160;
 
-  const auto spriteHeight = [&] { return isBigSprite() ? double_tile_h : tile_h; };
-  const auto numberOfBytesToFetch = [&] { return spriteHeight() * tileline_size; };
+// Sets or clears the bit of the sprite on the lines its y in OAM puts it on. Its x doesn't matter: one off the sides
+// of the screen still takes one of the 10 places of the line, as on hardware.
+void PPU::indexSprite(const std::size_t sprite, const bool on) noexcept {
+  const byte y = m_state.oam[sprite * sprite_size + 0];
+  if(y < sprite_starts_visible_y || y >= sprite_ends_visible_y) return;
 
-  const auto isSpriteOutsideOfTheViewport = [&](const byte x, const byte y) -> bool {
-    return x < sprite_starts_visible_x || //
-           x >= sprite_ends_visible_x ||  //
-           y < sprite_starts_visible_y || //
-           y >= sprite_ends_visible_y;
-  };
+  const std::uint64_t bit = std::uint64_t{1} << sprite;
+  const int viewport_y = y - sprite_viewport_offset_y;
 
-  const auto isSpriteVisibleToScanline = [&](const byte y) -> bool {
-    const int viewport_y = y - sprite_viewport_offset_y;
+  for(const bool big : {false, true}) {
+    const int spriteHeight = big ? double_tile_h : tile_h;
+    auto &lines = m_sprites_on_line[big];
 
-    return io.LY >= viewport_y && io.LY < (viewport_y + spriteHeight());
-  };
+    for(int ly = std::max(viewport_y, 0); ly < std::min(viewport_y + spriteHeight, int{viewport_h}); ++ly) {
+      if(on) lines[ly] |= bit;
+      else lines[ly] &= ~bit;
+    }
+  }
+}
 
-  // No idea how the lambda body works below...
-  // link: https://graphics.stanford.edu/~seander/bithacks.html#ReverseByteWith64BitsDiv
-  const auto reverseBits = [](const byte b) { return (b * 0x0202020202ULL & 0x010884422010ULL) % 1023; };
+void PPU::indexSprites() noexcept {
+  for(auto &lines : m_sprites_on_line)
+    lines.fill(0);
 
-  // clang-format off
-  if(is_oam_changed) {
-    is_oam_changed = false;
-    oam_view = m_oam | rv::chunk(4); // [y, x, tile_index, atrb] x 40
-  }
+  for(std::size_t sprite = 0; sprite < sprites; ++sprite)
+    indexSprite(sprite, true);
+}
 
-  const auto
-  sprites_on_scanline = oam_view
-                        | rv::remove_if([&](const auto &o) { return isSpriteOutsideOfTheViewport(o[1], o[0]); })
-                        | rv::filter([&](const auto &o) { return isSpriteVisibleToScanline(o[0]); })
-                        | rg::to<std::vector>
-                        | ra::sort(rg::greater{}, [](const auto& o) { return o[1]; })
-                        | ra::take(max_sprites_on_viewport_x);
+void PPU::fetchSprites() noexcept {
+  const int spriteHeight = isBigSprite() ? double_tile_h : tile_h;
 
-  for(const auto &obj : sprites_on_scanline) { // scan a line from each tiles
+  // the first 10 in OAM on this line, as the hardware picks them
+  std::array<const byte *, max_sprites_on_viewport_x> sprites_on_scanline;
+  std::size_t count = 0;
+
+  for(std::uint64_t on_line = m_sprites_on_line[isBigSprite()][m_state.io.LY];
+      on_line != 0 && count < sprites_on_scanline.size(); on_line &= on_line - 1)
+    sprites_on_scanline[count++] = m_state.oam.data() + std::countr_zero(on_line) * sprite_size;
+
+  // Drawn from right to left, the leftmost ends up on top. Between two on the same x, the first in OAM does.
+  std::sort(sprites_on_scanline.begin(), sprites_on_scanline.begin() + count, [](const byte *a, const byte *b) {
+    return a[1] != b[1] ? a[1] > b[1] : a > b;
+  });
+
+  palette_index_t *const line = m_framebuffer.data() + m_state.io.LY * viewport_w;
+
+  for(std::size_t n = 0; n < count; ++n) { // scan a line from each tiles
+    // clang-format off
+    const byte *const obj = sprites_on_scanline[n];
     const byte y     = obj[0];
     const byte x     = obj[1];
     const byte index = obj[2];
@@ -542,40 +559,31 @@ void PPU::fetchSprites() {
     const bool palette       = atrb & 0b0001'0000; // OBP1 or OBP0?
     // clang-format on
 
-    const std::size_t tile_address = index * tile_size;
-    auto sprite = rv::counted(m_vram.begin() + tile_address, numberOfBytesToFetch()) | rg::to<std::vector<byte>>;
-
-    if(yflip)
-      sprite = sprite                     //
-               | rv::const_               //
-               | rv::chunk(tileline_size) //
-               | rv::reverse              //
-               | rv::join                 //
-               | rg::to<std::vector<byte>>;
-
-    if(xflip) ra::transform(sprite, reverseBits);
+    if(x < sprite_starts_visible_x || x >= sprite_ends_visible_x) continue; // off the sides, picked but not drawn
 
     const int viewport_y = y - sprite_viewport_offset_y;
     const int viewport_x = x - sprite_viewport_offset_x;
     const int currently_scanning_spriteline = currentScanline() - viewport_y;
 
-    const auto spriteLines = sprite | rv::chunk(tileline_size);
-    const auto spriteLine_to_scan = spriteLines[currently_scanning_spriteline];
-    const auto decoded = decodeTilelinePaletteIndices(spriteLine_to_scan[0], spriteLine_to_scan[1]);
+    // y flipped, the tile lines are reversed
+    const int spriteline = yflip ? spriteHeight - 1 - currently_scanning_spriteline : currently_scanning_spriteline;
+    const decoded_tile_t &decoded_tile = tile(index + spriteline / tile_h); // past line 8, the second tile of a 8x16
+    const auto &lines = xflip ? decoded_tile.xflipped : decoded_tile.lines;
+    const tileline_t &decoded = lines[spriteline % tile_h];
+
+    const std::array<palette_index_t, 4> &colors = bgHasPriority ? m_bgp.colors  //
+                                                   : palette     ? m_obp1.colors //
+                                                                 : m_obp0.colors;
 
-    for(const int i : rv::iota(std::size_t{0}, tile_w)) {
+    for(int i = 0; i < static_cast<int>(tile_w); ++i) {
       if(viewport_x + i < 0) continue;
-      if(viewport_x + i >= sprite_ends_visible_x) break;
+      if(viewport_x + i >= static_cast<int>(viewport_w)) break;
 
       if(decoded[i] == 0b00) continue; // "transparent" color, palette index 0 is disallowed for sprites (by spec).
 
-      m_framebuffer[io.LY * viewport_w + viewport_x + i] = bgHasPriority ? bgp()[decoded[i]]  //
-                                                           : palette     ? obp1()[decoded[i]] //
-                                                                         : obp0()[decoded[i]];
+      line[viewport_x + i] = colors[decoded[i]];
 #if defined(WITH_DEBUGGER)
-      m_sprites_framebuffer[io.LY * viewport_w + viewport_x + i] = bgHasPriority ? bgp()[decoded[i]]  //
-                                                                   : palette     ? obp1()[decoded[i]] //
-                                                                                 : obp0()[decoded[i]];
+      m_sprites_framebuffer[m_state.io.LY * viewport_w + viewport_x + i] = colors[decoded[i]];
 #endif
     }
   }
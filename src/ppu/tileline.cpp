@@ -0,0 +1,27 @@
+#include <LR35902/config.h>
+#include <LR35902/ppu/tileline.h>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace LR35902 {
+
+static_assert(sizeof(tileline_t) == sizeof(std::uint64_t));
+
+// An index is bit 0 from the lower byte and bit 1 from the upper one: each line is the lower byte decoded alone, ORed
+// with the upper byte decoded alone and shifted. Only those 256 are decoded a bit at a time, the whole table that way
+// would go past what the compilers allow a constant evaluation to take.
+constinit const std::array<std::uint64_t, 0x10000> tileline_lut = [] {
+  std::array<std::uint64_t, 0x100> bit0{};
+  for(std::size_t b = 0; b < bit0.size(); ++b)
+    bit0[b] = std::bit_cast<std::uint64_t>(decodeTilelineBits(b, 0));
+
+  std::array<std::uint64_t, 0x10000> lut{};
+  for(std::size_t i = 0; i < lut.size(); ++i)
+    lut[i] = bit0[i & 0xff] | bit0[i >> 8] << 1;
+  return lut;
+}();
+
+}
@@ -0,0 +1,123 @@
+#include <LR35902/bus/bus.h>
+#include <LR35902/cartridge/cartridge.h>
+#include <LR35902/config.h>
+#include <LR35902/cpu/cpu.h>
+#include <LR35902/ppu/ppu.h>
+#include <LR35902/savestate/savestate.h>
+#include <LR35902/scheduler/scheduler.h>
+#include <LR35902/state/state.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace LR35902 {
+
+namespace {
+// clang-format off
+template <typename... Ts> struct overloaded : Ts... { using Ts::operator()...; };
+template <typename... Ts> overloaded(Ts...) -> overloaded<Ts...>;
+// clang-format on
+}
+
+SaveState::header_t SaveState::header() const noexcept {
+  const Cartridge &cart = m.cart;
+  const std::uint32_t checksum = cart.size() > 0x014f ? cart.data()[0x014e] << 8 | cart.data()[0x014f] : 0;
+  const bool boot_rom = cart.is_bootROM_mapped;
+
+  return {magic, version, cart.size(), checksum, boot_rom, 0};
+}
+
+template <typename Archive>
+void SaveState::transfer(Archive &a) {
+  a(m.cpu.mode);
+  a(m.cpu.m_halt_bug);
+  a(m.cpu.m_retired);
+  a(m.cpu.m_skipped_cycles);
+
+  a(m.state);
+  a(m.ppu.m_framebuffer);
+
+  a(m.cart.m_open_bus.m_engine);
+  std::visit(overloaded{
+                 [&](rom_only &) {},
+                 [&](rom_ram &cart) { a(cart.m_sram); },
+                 [&](mbc1 &cart) {
+                   a.bytes(cart.m_sram);
+                   a(cart.m_open_bus.m_engine);
+                 },
+                 [&](mbc2 &cart) {
+                   a(cart.m_sram);
+                   a(cart.m_open_bus.m_engine);
+                 },
+                 [&](mbc3 &cart) {
+                   a(cart.RTC);
+                   a(cart.latch_checker);
+                   a(cart.is_latch_open);
+                   a.bytes(cart.m_sram);
+                   a(cart.m_open_bus.m_engine);
+                 },
+                 [&](mbc5 &cart) {
+                   a.bytes(cart.m_sram);
+                   a(cart.m_open_bus.m_engine);
+                 },
+             },
+             m.cart.m_cart);
+}
+
+void SaveState::save(std::vector<byte> &out) {
+  header_t h = header();
+
+  m.cpu.settleFlags(); // the registers are saved along with the State
+
+  out.clear();
+  writer w{out};
+  w(h);
+  transfer(w);
+
+  h.body_size = out.size() - sizeof(header_t);
+  std::memcpy(out.data(), &h, sizeof(header_t));
+}
+
+bool SaveState::load(const std::span<const byte> in) noexcept {
+  header_t saved;
+  if(in.size() < sizeof(header_t)) return false;
+  std::memcpy(&saved, in.data(), sizeof(header_t));
+
+  header_t expected = header();
+  counter c;
+  transfer(c);
+  expected.body_size = c.size();
+
+  if(saved.magic != expected.magic || saved.version != expected.version || saved.rom_size != expected.rom_size ||
+     saved.rom_checksum != expected.rom_checksum || saved.body_size != expected.body_size ||
+     in.size() != sizeof(header_t) + saved.body_size)
+    return false;
+
+  if(saved.boot_rom && !m.cart.is_bootROM_successfully_loaded) return false; // there is no boot ROM to map back
+  m.cart.is_bootROM_mapped = saved.boot_rom;
+
+  reader r{in.subspan(sizeof(header_t))};
+  transfer(r);
+
+  // what is derived from the state
+  std::visit(overloaded{
+                 [](rom_only &) {},
+                 [](rom_ram &) {},
+                 [&](auto &cart) { cart.select_banks(m.state.mbc); },
+             },
+             m.cart.m_cart);
+  m.cpu.dropFlags();
+  m.cpu.m_blocks.leave();
+  m.cpu.m_idle_loop = {};
+  m.ppu.invalidate();
+  m.bus.remap(); // the page table, and a new version of every page drops the decoded blocks
+  m.scheduler.reschedule();
+
+  return true;
+}
+
+}
@@ -0,0 +1,62 @@
+#include <LR35902/cpu/clock/clock.h>
+#include <LR35902/ppu/ppu.h>
+#include <LR35902/scheduler/scheduler.h>
+#include <LR35902/state/state.h>
+#include <LR35902/timer/timer.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace LR35902 {
+
+Scheduler::Scheduler(State &state, Clock &clock, PPU &ppu, Timer &timer) noexcept :
+    m_state{state},
+    m_clock{clock},
+    m_ppu{ppu},
+    m_timer{timer} {
+  reschedule();
+}
+
+void Scheduler::schedule(const event e, const std::optional<std::uint64_t> at) noexcept {
+  m_deadlines[static_cast<std::size_t>(e)] = at;
+  m_clock.deadline(next());
+}
+
+void Scheduler::limit(const std::optional<std::uint64_t> at) noexcept {
+  m_limit = at;
+  m_clock.deadline(next());
+}
+
+std::uint64_t Scheduler::next() const noexcept {
+  std::uint64_t earliest = m_state.synced + max_slice;
+  for(const std::optional<std::uint64_t> &at : m_deadlines)
+    if(at) earliest = std::min(earliest, *at);
+  if(m_limit) earliest = std::min(earliest, *m_limit);
+
+  return earliest;
+}
+
+void Scheduler::sync() noexcept {
+  const std::uint64_t now = m_clock.data();
+  const std::size_t elapsed = now - m_state.synced;
+  m_state.synced = now;
+
+  m_ppu.update(elapsed);
+  m_timer.update(elapsed);
+
+  reschedule();
+}
+
+void Scheduler::reschedule() noexcept {
+  const auto after = [&](const std::optional<std::size_t> cycles) -> std::optional<std::uint64_t> {
+    if(cycles) return m_state.synced + *cycles;
+    return std::nullopt;
+  };
+
+  schedule(event::ppu, after(m_ppu.nextEvent()));
+  schedule(event::timer, after(m_timer.nextEvent()));
+}
+
+}
@@ -1,7 +1,11 @@
+#include <LR35902/config.h>
 #include <LR35902/interrupt/interrupt.h>
 #include <LR35902/io/io.h>
+#include <LR35902/state/state.h>
 #include <LR35902/timer/timer.h>
 
+#include <array>
+#include <optional>
 #include <ranges>
 
 #include <cstddef>
@@ -40,43 +44,46 @@ constexpr std::size_t div_increase_rate = frequency_select[2];
 
 // clang-format on
 
-Timer::Timer(IO &io, Interrupt &intr) :
-    m_io{io},
+// TIMA counts the falling edges of this bit of the internal divider counter
+constexpr std::array<std::size_t, 4> tima_bit{8, 2, 4, 6};
+
+Timer::Timer(State &state, Interrupt &intr) :
+    m_state{state},
     m_intr{intr} {}
 
 void Timer::update(const std::size_t cycles) noexcept {
-  counter += cycles;
-  div_counter += cycles;
-
-  if(div_counter > div_increase_rate) {
-    div_counter -= div_increase_rate;
-    ++m_io.DIV;
-  }
-
-  if(const bool isTimerOn = m_io.TAC & 0b0000'0100; isTimerOn) {
-    const std::size_t frequency_index = m_io.TAC & 0b0000'0011;
-
-    const std::uint16_t bit_to_check = [&] {
-      switch(frequency_index) {
-      case 0: return 8;
-      case 1: return 2;
-      case 2: return 4;
-      case 3: return 6;
+  const std::uint64_t previous_counter = m_state.timer_counter;
+  m_state.timer_counter += cycles;
+  m_state.div_counter += cycles;
+
+  m_state.io.DIV = static_cast<byte>(m_state.io.DIV + m_state.div_counter / div_increase_rate);
+  m_state.div_counter %= div_increase_rate;
+
+  if(const bool isTimerOn = m_state.io.TAC & 0b0000'0100; isTimerOn) {
+    // the bit falls each time the internal divider counter passes a multiple of twice its weight
+    const std::size_t period = std::size_t{2} << tima_bit[m_state.io.TAC & 0b0000'0011];
+    std::uint64_t edges = m_state.timer_counter / period - previous_counter / period;
+
+    while(edges != 0) {
+      const std::size_t until_overflow = 0x100 - m_state.io.TIMA;
+      if(edges < until_overflow) {
+        m_state.io.TIMA = static_cast<byte>(m_state.io.TIMA + edges);
+        break;
       }
-    }();
 
-    byte prev_bit = (previous_counter >> bit_to_check) & 1;
-    byte current_bit = (counter >> bit_to_check) & 1;
-
-    if(prev_bit == 1 && current_bit == 0) {
-      if(++m_io.TIMA == 0x00) {                 // 0xff->0x00 timer overflowed
-        m_intr.request(Interrupt::kind::timer); // request interrupt
-        m_io.TIMA = m_io.TMA;                   // load it to Timer Modulo Accumulator
-      }
+      edges -= until_overflow;
+      m_intr.request(Interrupt::kind::timer); // 0xff->0x00 timer overflowed
+      m_state.io.TIMA = m_state.io.TMA;       // load it to Timer Modulo Accumulator
     }
   }
+}
+
+std::optional<std::size_t> Timer::nextEvent() const noexcept {
+  if(const bool isTimerOn = m_state.io.TAC & 0b0000'0100; !isTimerOn) return std::nullopt;
 
-  previous_counter = counter;
+  const std::size_t period = std::size_t{2} << tima_bit[m_state.io.TAC & 0b0000'0011];
+  const std::size_t until_overflow = 0x100 - m_state.io.TIMA;
+  return (m_state.timer_counter / period + until_overflow) * period - m_state.timer_counter;
 }
 
 } // end namespace LR35902
@@ -0,0 +1,112 @@
+#include <LR35902/cartridge/header/header.h>
+#include <LR35902/config.h>
+#include <LR35902/memory_map.h>
+#include <backend/Emu.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// "CPU dispatch" measures the interpreter core alone, no PPU or timer updates in between.
+// To compare the dispatch strategies, build once with -DTHREADED_DISPATCH=ON and once with OFF, then run both on the
+// same ROM. Set LR35902_BENCHMARK_ROM=path/to/rom.gb to use a real game, otherwise a synthetic loop made of loads,
+// ALU, 0xCB prefixed, stack and control flow instructions is used.
+// The same goes for the flags, -DLAZY_FLAGS=ON against OFF.
+
+using namespace LR35902;
+namespace fs = std::filesystem;
+
+namespace {
+
+// clang-format off
+constexpr byte synthetic_program[] {
+                      // 0x0150:
+  0xf3,               //   di
+  0x31, 0xfe, 0xdf,   //   ld sp,0xdffe
+  0x21, 0x00, 0xc0,   //   ld hl,0xc000
+                      // 0x0157: loop
+  0x7e,               //   ld a,[hl]
+  0x80,               //   add a,b
+  0x22,               //   ld [hli],a
+  0x04,               //   inc b
+  0xcb, 0x37,         //   swap a
+  0xa9,               //   xor c
+  0x0d,               //   dec c
+  0xcd, 0x6c, 0x01,   //   call sub
+  0x7c,               //   ld a,h
+  0xfe, 0xd0,         //   cp 0xd0
+  0x20, 0xf0,         //   jr nz,loop
+  0x26, 0xc0,         //   ld h,0xc0
+  0x18, 0xec,         //   jr loop
+  0x00,               //   nop
+                      // 0x016c: sub
+  0xc5,               //   push bc
+  0xcb, 0x41,         //   bit 0,c
+  0xc1,               //   pop bc
+  0xc9                //   ret
+};
+// clang-format on
+
+std::string benchmarkROM() {
+  if(const char *const rom = std::getenv("LR35902_BENCHMARK_ROM")) return rom;
+
+  std::vector<byte> rom(32_KiB, byte{});
+
+  constexpr byte entry[]{0x00, 0xc3, 0x50, 0x01}; // nop, jp 0x0150
+  std::ranges::copy(entry, rom.begin() + mmap::entry_begin);
+  std::ranges::copy(nintendo_logo, rom.begin() + mmap::logo_begin);
+  std::ranges::copy(synthetic_program, rom.begin() + mmap::header_end);
+
+  const fs::path path = fs::temp_directory_path() / "lr35902_cpu.bench.gb";
+  std::ofstream fout{path, std::ios::binary};
+  fout.write(reinterpret_cast<const char *>(rom.data()), static_cast<std::streamsize>(rom.size()));
+
+  return path.string();
+}
+
+}
+
+TEST_CASE("CPU dispatch", "[benchmark]") {
+  constexpr std::size_t instructions = 1'000'000;
+
+  Emu emu;
+  REQUIRE(emu.plug(benchmarkROM()));
+  emu.skipBoot();
+  emu.clock.deadline(std::numeric_limits<std::uint64_t>::max()); // the scheduler would stop the CPU at the PPU events
+
+  const auto start = std::chrono::steady_clock::now();
+  emu.cpu.run(instructions);
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  std::printf("%.0f instructions/sec\n", instructions / elapsed.count());
+
+  BENCHMARK("1M instructions, one per call") {
+    for(std::size_t i = 0; i < instructions; ++i)
+      emu.cpu.run();
+  };
+
+  BENCHMARK("1M instructions, all in one call") {
+    emu.cpu.run(instructions);
+  };
+}
+
+// The whole machine, the CPU running between the events of the PPU and the timer
+TEST_CASE("Frames", "[benchmark]") {
+  Emu emu;
+  REQUIRE(emu.plug(benchmarkROM()));
+  emu.skipBoot();
+
+  BENCHMARK("1 frame") {
+    emu.update();
+  };
+}
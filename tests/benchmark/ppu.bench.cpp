@@ -0,0 +1,111 @@
+#include <LR35902/config.h>
+#include <LR35902/interrupt/interrupt.h>
+#include <LR35902/io/io.h>
+#include <LR35902/ppu/ppu.h>
+#include <LR35902/ppu/tileline.h>
+#include <LR35902/state/state.h>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// "Tile line decoding" times the decoding alone, "Scanlines" the PPU drawing whole frames of them: background, window
+// and 10 sprites on every line. Run it on two builds to compare renderers, the ns/scanline is printed first.
+
+using namespace LR35902;
+
+namespace {
+
+// The tile lines of a frame worth of scanlines, background and window: 144 lines x 21 tiles, twice. The lines come from
+// the 384 tiles of the tile set, as in a game, so the table is looked up at a few thousand different places.
+std::vector<std::uint16_t> tilelines() {
+  constexpr std::size_t lines_per_frame = 144 * 21 * 2;
+
+  std::minstd_rand engine{42};
+  std::vector<std::uint16_t> tileset(384 * 8);
+  for(auto &line : tileset)
+    line = static_cast<std::uint16_t>(engine());
+
+  std::vector<std::uint16_t> lines(lines_per_frame);
+  for(auto &line : lines)
+    line = tileset[engine() % tileset.size()];
+  return lines;
+}
+
+constexpr std::size_t cycles_per_frame = 154 * 114;
+
+void frame(PPU &ppu) {
+  for(std::size_t cycles = 0; cycles < cycles_per_frame;) {
+    const std::size_t next = *ppu.nextEvent();
+    ppu.update(next);
+    cycles += next;
+  }
+}
+
+}
+
+TEST_CASE("Tile line decoding", "[benchmark]") {
+  const std::vector<std::uint16_t> lines = tilelines();
+
+  BENCHMARK("a frame of lines, a bit at a time") {
+    std::uint64_t sum = 0;
+    for(const std::uint16_t line : lines)
+      for(const auto index : decodeTilelineBits(line & 0xff, line >> 8))
+        sum += index;
+    return sum;
+  };
+
+  BENCHMARK("a frame of lines, from the table") {
+    std::uint64_t sum = 0;
+    for(const std::uint16_t line : lines)
+      for(const auto index : decodeTileline(line & 0xff, line >> 8))
+        sum += index;
+    return sum;
+  };
+}
+
+TEST_CASE("Scanlines", "[benchmark]") {
+  State state;
+
+  std::minstd_rand engine{42};
+  for(auto &b : state.vram)
+    b = static_cast<byte>(engine());
+
+  // 40 sprites in 4 rows of 10 across the screen, each 16 lines tall: 10 on every line
+  for(std::size_t i = 0; i < 40; ++i) {
+    state.oam[i * 4 + 0] = static_cast<byte>(16 + (i / 10) * 36);  // y
+    state.oam[i * 4 + 1] = static_cast<byte>(8 + (i % 10) * 16);   // x
+    state.oam[i * 4 + 2] = static_cast<byte>(engine());            // tile
+    state.oam[i * 4 + 3] = static_cast<byte>(engine() & 0xf0);     // flips, palette and priority
+  }
+
+  IO &io = state.io;
+  io.LCDC = 0b1111'0111; // on, window and background at 0x9c00, sprites 8x16 and on, background on
+  io.BGP = 0xe4;
+  io.OBP0 = 0xd2;
+  io.OBP1 = 0x1b;
+  io.SCX = 3;
+  io.SCY = 5;
+  io.WY = 72;
+  io.WX = 87;
+
+  Interrupt intr{state};
+  PPU ppu{intr, state}; // after OAM is filled in, it's indexed on construction
+
+  constexpr std::size_t frames = 600;
+  const auto start = std::chrono::steady_clock::now();
+  for(std::size_t i = 0; i < frames; ++i)
+    frame(ppu);
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  std::printf("%.0f ns/scanline\n", elapsed.count() / (frames * PPU::viewport_h));
+
+  BENCHMARK("1 frame, 144 scanlines") {
+    frame(ppu);
+  };
+}
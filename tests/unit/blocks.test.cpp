@@ -0,0 +1,38 @@
+#include <backend/Emu.h>
+
+#include <LR35902/cpu/block_cache.h>
+#include <LR35902/memory_map.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace LR35902;
+
+TEST_CASE("Decoded blocks follow the code they came from", "Block cache") {
+  Emu emu;
+  BlockCache blocks{emu.bus};
+
+  constexpr address_t pc = mmap::wram0;
+  emu.bus.write(pc, 0x3c);     // inc a
+  emu.bus.write(pc + 1, 0x18); // jr -3
+  emu.bus.write(pc + 2, 0xfd);
+
+  REQUIRE(blocks.fetch(pc)->opcode == 0x3c);
+  REQUIRE(blocks.fetch(pc + 1)->opcode == 0x18);
+  blocks.leave();
+
+  SECTION("written through the bus") {
+    emu.bus.write(pc, 0x04); // inc b
+    REQUIRE(blocks.fetch(pc)->opcode == 0x04);
+    REQUIRE(blocks.fetch(pc + 1)->opcode == 0x18);
+  }
+
+  SECTION("edited in place, e.g. from the debugger") {
+    const_cast<byte *>(emu.bus.page(pc))[0] = 0x0c; // inc c
+    REQUIRE(blocks.fetch(pc)->opcode == 0x3c);      // nothing told the cache yet
+    blocks.leave();
+
+    emu.bus.invalidate(pc);
+    REQUIRE(blocks.fetch(pc)->opcode == 0x0c);
+    REQUIRE(blocks.fetch(pc + 1)->opcode == 0x18);
+  }
+}
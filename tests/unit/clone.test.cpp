@@ -0,0 +1,64 @@
+#include <LR35902/config.h>
+#include <backend/Emu.h>
+#include <tests/unit/machine.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace LR35902;
+using namespace LR35902::test;
+
+namespace {
+
+void run(Emu &emu, const int frames) {
+  for(int i = 0; i != frames; ++i)
+    emu.update();
+}
+
+}
+
+TEST_CASE("Clone", "A clone goes on exactly as the machine it was cloned from") {
+  const std::string rom = testROM("lr35902_clone.test.gb");
+
+  const auto emu = std::make_unique<Emu>();
+  emu->plug(rom);
+  emu->skipBoot();
+  run(*emu, 10);
+
+  const snapshot branched = take(*emu);
+
+  SECTION("in the same state, sharing the ROM") {
+    const auto child = emu->clone();
+    REQUIRE(take(*child) == branched);
+    REQUIRE(child->cart.data() == emu->cart.data());
+
+    run(*emu, 20);
+    run(*child, 20);
+    REQUIRE(take(*child) == take(*emu));
+  }
+
+  SECTION("apart from the machine it was cloned from") {
+    const auto child = emu->clone();
+
+    run(*child, 20);
+    REQUIRE(take(*emu) == branched);
+
+    child->bus.write(0xd100, 0xaa); // out of the way of the program
+    REQUIRE(emu->bus.read(0xd100) != 0xaa);
+  }
+
+  SECTION("into a machine reused for another branch") {
+    const auto child = emu->clone();
+    run(*child, 20);
+
+    emu->cloneInto(*child);
+    REQUIRE(take(*child) == branched);
+
+    run(*emu, 20);
+    run(*child, 20);
+    REQUIRE(take(*child) == take(*emu));
+  }
+}
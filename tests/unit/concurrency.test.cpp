@@ -0,0 +1,95 @@
+#include <LR35902/memory_map.h>
+#include <backend/BatchRunner.h>
+#include <backend/Emu.h>
+#include <tests/unit/machine.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Machines share no mutable state, so running N of them at once on N threads gives bit for bit what running them one
+// after the other gives.
+
+using namespace LR35902;
+using namespace LR35902::test;
+
+namespace {
+
+constexpr int frames = 30;
+
+snapshot run(const std::string &rom) {
+  const auto emu = std::make_unique<Emu>();
+  emu->plug(rom);
+  emu->skipBoot();
+
+  for(int i = 0; i != frames; ++i)
+    emu->update();
+
+  return take(*emu);
+}
+
+}
+
+TEST_CASE("Concurrency", "Machines running on threads match the ones running one after the other") {
+  const std::string rom = testROM("lr35902_concurrency.test.gb");
+
+  const std::size_t n = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 2, 8);
+
+  std::vector<snapshot> sequential;
+  for(std::size_t i = 0; i != n; ++i)
+    sequential.push_back(run(rom));
+
+  std::vector<snapshot> concurrent(n);
+  {
+    std::vector<std::jthread> threads;
+    for(std::size_t i = 0; i != n; ++i)
+      threads.emplace_back([&, i] { concurrent[i] = run(rom); });
+  }
+
+  REQUIRE(sequential.front().cycles > 0);
+  REQUIRE(sequential.front().wram[0xd000 - mmap::wram0] != 0); // the timer interrupt was served
+
+  for(std::size_t i = 0; i != n; ++i) {
+    REQUIRE(sequential[i] == sequential.front());
+    REQUIRE(concurrent[i] == sequential[i]);
+  }
+}
+
+TEST_CASE("BatchRunner", "Machines running in a batch match the ones running one after the other") {
+  const std::string rom = testROM("lr35902_concurrency.test.gb");
+  const snapshot expected = run(rom);
+
+  BatchRunner batch{4};
+  REQUIRE_FALSE(batch.add("no such rom").has_value());
+
+  constexpr std::size_t n = 16;
+  std::vector<std::size_t> completed(n);
+  for(std::size_t i = 0; i != n; ++i) {
+    const std::optional<std::size_t> id = batch.add(rom);
+    REQUIRE(id == i);
+    batch.onComplete(*id, [&](const std::size_t id, Emu &) { ++completed[id]; });
+  }
+
+  for(int i = 0; i != frames; ++i)
+    batch.tick({BatchRunner::budget::frames, 1});
+
+  for(std::size_t i = 0; i != n; ++i) {
+    REQUIRE(completed[i] == static_cast<std::size_t>(frames));
+    REQUIRE(take(batch[i]) == expected);
+  }
+
+  SECTION("a cycle budget runs at least that many cycles, stopping on the first instruction past them") {
+    batch.tick({BatchRunner::budget::cycles, 1000});
+
+    for(std::size_t i = 0; i != n; ++i) {
+      REQUIRE(batch[i].clock.data() >= expected.cycles + 1000);
+      REQUIRE(batch[i].clock.data() < expected.cycles + 1000 + 6 + 5); // an instruction and an interrupt at most
+    }
+  }
+}
@@ -0,0 +1,60 @@
+#include <LR35902/config.h>
+#include <LR35902/cpu/registers/register_file.h>
+#include <LR35902/memory_map.h>
+#include <backend/Emu.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <memory>
+
+using namespace LR35902;
+
+TEST_CASE("Halt", "Waits up to the deadline, never past it") {
+  const auto emu = std::make_unique<Emu>();
+  emu->skipBoot();
+
+  emu->bus.write(mmap::IE, 0);  // nothing wakes it up
+  emu->bus.write(0xc000, 0x76); // halt
+  register_file registers = emu->cpu.registers();
+  registers.PC.m_data = 0xc000;
+  emu->cpu.registers(registers);
+
+  emu->clock.deadline(emu->clock.data() + 100);
+  emu->cpu.run();
+  REQUIRE(emu->clock.data() == emu->clock.deadline()); // idled up to it
+
+  SECTION("the deadline already in the past") {
+    const std::uint64_t now = emu->clock.data() + 4; // e.g. an interrupt dispatched on the way
+    emu->clock.cycle(4);
+    emu->clock.deadline(now - 6);
+
+    emu->cpu.run(); // still halted
+    REQUIRE(emu->clock.data() == now);
+    REQUIRE(emu->clock.due());
+  }
+}
+
+TEST_CASE("Halt bug", "The byte after halt is read twice") {
+  const auto emu = std::make_unique<Emu>();
+  emu->skipBoot();
+
+  emu->bus.write(mmap::IE, 0b100); // timer
+  emu->bus.write(0xff0f, 0b100);   // requested, with ime reset
+  for(address_t at = 0xc000; const byte b : {0x76, 0x3e, 0x14}) // halt; ld a,0x14
+    emu->bus.write(at++, b);
+
+  register_file registers = emu->cpu.registers();
+  registers.PC.m_data = 0xc000;
+  registers.ime = false;
+  registers.D = 0;
+  emu->cpu.registers(registers);
+
+  emu->cpu.run(2); // halt, then 0x3e read as the opcode and as its immediate
+  REQUIRE(emu->cpu.registers().A == 0x3e);
+  REQUIRE(emu->cpu.registers().PC.m_data == 0xc002);
+
+  emu->cpu.run(1); // 0x14 is an instruction of its own, inc d
+  REQUIRE(emu->cpu.registers().D == 1);
+  REQUIRE(emu->cpu.registers().PC.m_data == 0xc003);
+}
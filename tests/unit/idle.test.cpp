@@ -0,0 +1,62 @@
+#include <LR35902/config.h>
+#include <LR35902/cpu/registers/register_file.h>
+#include <backend/Emu.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+using namespace LR35902;
+
+namespace {
+
+constexpr address_t loop = 0xc000;
+constexpr address_t exit = loop + 4;
+constexpr std::array<byte, 6> code{
+  0xcb, 0x56, // bit 2,[hl]
+  0x28, 0xfc, // jr z,loop
+  0x18, 0xfe, // exit: jr exit
+};
+
+// runs the loop from its start with HL pointing at polled, returns the cycle it is left at
+std::uint64_t poll(Emu &emu, const address_t polled) {
+  register_file registers = emu.cpu.registers();
+  registers.PC.m_data = loop;
+  registers.H = polled >> 8;
+  registers.L = polled & 0xff;
+  emu.cpu.registers(registers);
+
+  for(int i = 0; i < 100'000 && emu.cpu.registers().PC.m_data != exit; ++i) {
+    emu.cpu.run();
+    emu.scheduler.sync();
+  }
+  return emu.clock.data();
+}
+
+}
+
+TEST_CASE("Idle loops", "Skipped iterations end where they would have") {
+  const auto skipping = std::make_unique<Emu>();
+  const auto reference = std::make_unique<Emu>();
+  reference->cpu.skipIdleLoops(false);
+
+  for(Emu *const emu : {skipping.get(), reference.get()}) {
+    emu->skipBoot();
+    emu->bus.write(0xff40, 0);    // LCDC, off so only the timer has events
+    emu->bus.write(0xff07, 0b101); // TAC, TIMA overflows every 1024 cycles
+    emu->bus.write(0xff05, 0);     // TIMA
+    emu->bus.write(0xff0f, 0);     // IF
+    for(address_t at = loop; const byte b : code)
+      emu->bus.write(at++, b);
+  }
+
+  REQUIRE(poll(*skipping, 0xff0f) == poll(*reference, 0xff0f)); // IF, the timer requests its interrupt on an event
+  const std::uint64_t skipped = skipping->cpu.skippedCycles();
+  REQUIRE(skipped > 0);
+
+  // the very same loop, now polling DIV, which changes without any event
+  REQUIRE(poll(*skipping, 0xff04) == poll(*reference, 0xff04));
+  REQUIRE(skipping->cpu.skippedCycles() == skipped);
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <LR35902/cartridge/header/header.h>
+#include <LR35902/config.h>
+#include <LR35902/cpu/registers/register_file.h>
+#include <LR35902/memory_map.h>
+#include <backend/Emu.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// A synthetic ROM keeping most of the machine busy (the timer and its interrupt, the LCD, VRAM, WRAM, reads of the
+// missing cartridge RAM) and what of a machine running it is compared, for the tests that run whole machines.
+
+namespace LR35902::test {
+
+// clang-format off
+constexpr byte timer_handler[] {
+                      // 0x0050:
+  0xf5,               //   push af
+  0xe5,               //   push hl
+  0x21, 0x00, 0xd0,   //   ld hl,0xd000
+  0x34,               //   inc [hl]
+  0xe1,               //   pop hl
+  0xf1,               //   pop af
+  0xd9                //   reti
+};
+
+constexpr byte program[] {
+                      // 0x0150:
+  0x31, 0xfe, 0xdf,   //   ld sp,0xdffe
+  0x3e, 0x05,         //   ld a,0x05
+  0xe0, 0x07,         //   ldh [TAC],a
+  0x3e, 0x04,         //   ld a,0x04
+  0xe0, 0xff,         //   ldh [IE],a
+  0xfb,               //   ei
+  0x21, 0x00, 0xc0,   //   ld hl,0xc000
+  0x11, 0x00, 0x80,   //   ld de,0x8000
+                      // 0x0162: loop
+  0xfa, 0x00, 0xa0,   //   ld a,[0xa000] ; no cartridge RAM, open bus
+  0xae,               //   xor [hl]
+  0x22,               //   ld [hli],a
+  0x12,               //   ld [de],a
+  0x13,               //   inc de
+  0x7c,               //   ld a,h
+  0xfe, 0xd0,         //   cp 0xd0
+  0x20, 0xf4,         //   jr nz,loop
+  0x26, 0xc0,         //   ld h,0xc0
+  0x16, 0x80,         //   ld d,0x80
+  0x18, 0xee          //   jr loop
+};
+// clang-format on
+
+// writes the ROM to path, e.g. for gb.recomp to compile it at build time
+inline void writeROM(const std::filesystem::path &path) {
+  std::vector<byte> rom(32_KiB, byte{});
+
+  constexpr byte entry[]{0x00, 0xc3, 0x50, 0x01}; // nop, jp 0x0150
+  std::ranges::copy(timer_handler, rom.begin() + 0x50);
+  std::ranges::copy(entry, rom.begin() + mmap::entry_begin);
+  std::ranges::copy(nintendo_logo, rom.begin() + mmap::logo_begin);
+  std::ranges::copy(program, rom.begin() + mmap::header_end);
+
+  std::ofstream fout{path, std::ios::binary};
+  fout.write(reinterpret_cast<const char *>(rom.data()), static_cast<std::streamsize>(rom.size()));
+}
+
+// writes the ROM into the temporary directory under the given name, returns its path
+inline std::string testROM(const std::string &name) {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+  writeROM(path);
+  return path.string();
+}
+
+struct snapshot {
+  register_file registers;
+  std::uint64_t cycles;
+  std::vector<std::uint8_t> framebuffer;
+  std::vector<byte> wram;
+
+  bool operator==(const snapshot &) const = default;
+};
+
+inline snapshot take(Emu &emu) {
+  snapshot s{emu.cpu.registers(), emu.clock.data(), {}, {}};
+
+  const auto &framebuffer = emu.ppu.getFrameBuffer();
+  s.framebuffer.assign(framebuffer.begin(), framebuffer.end());
+
+  for(std::size_t i = mmap::wram0; i != mmap::echo; ++i)
+    s.wram.push_back(emu.bus.read(static_cast<address_t>(i)));
+
+  return s;
+}
+
+}
@@ -1,5 +1,6 @@
 #include <LR35902/cartridge/kind/mbc1.h>
 #include <LR35902/cartridge/kind/mbc_config.h>
+#include <LR35902/cartridge/kind/mbc_registers.h>
 #include <LR35902/config.h>
 #include <LR35902/memory_map.h>
 
@@ -7,6 +8,7 @@
 
 #include <cstddef>
 #include <utility>
+#include <vector>
 
 using namespace LR35902;
 
@@ -25,15 +27,16 @@ TEST_CASE("Memory bank controller cartridge type 1", "Read/Write ROM") {
   REQUIRE(ROM[3 * 16_KiB] == 13 + 3);
   REQUIRE(ROM[127 * 16_KiB] == 13 + 127);
 
-  mbc1 cart{std::move(ROM), {.sram_size = 32_KiB}};
+  mbc_registers registers;
+  mbc1 cart{rom_image::copy(std::move(ROM)), {.sram_size = 32_KiB}, registers};
   enum : int { reg0 = 0, reg1 = 1, reg2 = 2, reg3 = 3 };
 
-  const auto selectRegister = [&cart](const int reg, const byte val) {
+  const auto selectRegister = [&cart, &registers](const int reg, const byte val) {
     switch(reg) {
-    case 0: cart.writeROM(0x0000, val); break;
-    case 1: cart.writeROM(0x2000, val); break;
-    case 2: cart.writeROM(0x4000, val); break;
-    case 3: cart.writeROM(0x6000, val); break;
+    case 0: cart.writeROM(registers, 0x0000, val); break;
+    case 1: cart.writeROM(registers, 0x2000, val); break;
+    case 2: cart.writeROM(registers, 0x4000, val); break;
+    case 3: cart.writeROM(registers, 0x6000, val); break;
     }
   };
 
@@ -85,32 +88,32 @@ TEST_CASE("Memory bank controller cartridge type 1", "Read/Write ROM") {
   SECTION("RAM operations") {
     selectRegister(reg3, 0); // disable ram banking
     selectRegister(reg0, 0); // disable ram gate register
-    cart.writeSRAM(0, 123);  // white should have no effect, read should return random value
-    REQUIRE_FALSE(cart.readSRAM(0) == 123);
+    cart.writeSRAM(registers, 0, 123);  // white should have no effect, read should return random value
+    REQUIRE_FALSE(cart.readSRAM(registers, 0) == 123);
 
     selectRegister(reg0, 0x0a); // enable ram gate register
-    cart.writeSRAM(0, 123);
-    REQUIRE(cart.readSRAM(0) == 123);
+    cart.writeSRAM(registers, 0, 123);
+    REQUIRE(cart.readSRAM(registers, 0) == 123);
 
     selectRegister(reg3, 1); // enable ram banking
     selectRegister(reg2, 0); // read from bank 0
-    REQUIRE(cart.readSRAM(0) == 123);
+    REQUIRE(cart.readSRAM(registers, 0) == 123);
 
     selectRegister(reg2, 1);
-    cart.writeSRAM(0, 0xab);
-    REQUIRE(cart.readSRAM(0) == 0xab);
+    cart.writeSRAM(registers, 0, 0xab);
+    REQUIRE(cart.readSRAM(registers, 0) == 0xab);
 
     selectRegister(reg2, 2);
-    cart.writeSRAM(0, 0xbc);
-    REQUIRE(cart.readSRAM(0) == 0xbc);
+    cart.writeSRAM(registers, 0, 0xbc);
+    REQUIRE(cart.readSRAM(registers, 0) == 0xbc);
 
     selectRegister(reg2, 3);
-    cart.writeSRAM(0, 0xcd);
-    REQUIRE(cart.readSRAM(0) == 0xcd);
+    cart.writeSRAM(registers, 0, 0xcd);
+    REQUIRE(cart.readSRAM(registers, 0) == 0xcd);
 
     STATIC_CHECK(4 == 0b100);
     STATIC_CHECK((0b100 & 0x03) == 00);
     selectRegister(reg2, 4);
-    REQUIRE(cart.readSRAM(0) == 123);
+    REQUIRE(cart.readSRAM(registers, 0) == 123);
   }
 }
@@ -1,5 +1,6 @@
 #include <LR35902/cartridge/kind/mbc2.h>
 #include <LR35902/cartridge/kind/mbc_config.h>
+#include <LR35902/cartridge/kind/mbc_registers.h>
 #include <LR35902/config.h>
 #include <LR35902/memory_map.h>
 
@@ -7,6 +8,7 @@
 
 #include <cstddef>
 #include <utility>
+#include <vector>
 
 using namespace LR35902;
 
@@ -26,36 +28,37 @@ TEST_CASE("Memory bank controller type 2", "ROM banking behavior") {
   REQUIRE(ROM[3 * 16_KiB] == 34 + 3);
   REQUIRE(ROM[15 * 16_KiB] == 34 + 15);
 
-  mbc2 cart{std::move(ROM), {.has_battery = false}};
+  mbc_registers registers;
+  mbc2 cart{rom_image::copy(std::move(ROM)), {.has_battery = false}, registers};
 
   SECTION("ROM Operations") {
     REQUIRE(cart.readROM(0) == 34);
 
-    cart.writeROM(0x0100, 0); // selecting bank 0 should default to 1
+    cart.writeROM(registers, 0x0100, 0); // selecting bank 0 should default to 1
     REQUIRE(cart.readROM(mmap::romx) == 34 + 1);
 
-    cart.writeROM(0x0100, 1);
+    cart.writeROM(registers, 0x0100, 1);
     REQUIRE(cart.readROM(mmap::romx) == 34 + 1);
 
-    cart.writeROM(0x0100, 2);
+    cart.writeROM(registers, 0x0100, 2);
     REQUIRE(cart.readROM(mmap::romx) == 34 + 2);
 
-    cart.writeROM(0x0100, 15);
+    cart.writeROM(registers, 0x0100, 15);
     REQUIRE(cart.readROM(mmap::romx) == 34 + 15);
   }
 
   SECTION("RAM Operations") {
-    cart.writeROM(0x0000, 0x0A); // ram enabled
+    cart.writeROM(registers, 0x0000, 0x0A); // ram enabled
 
-    cart.writeSRAM(mmap::sram, 0xab); // writing should discard upper nibble of the byte
-    REQUIRE(cart.readSRAM(mmap::sram) == 0x0b);
+    cart.writeSRAM(registers, mmap::sram, 0xab); // writing should discard upper nibble of the byte
+    REQUIRE(cart.readSRAM(registers, mmap::sram) == 0x0b);
 
-    cart.writeSRAM(mmap::sram + 3, 0x12);
+    cart.writeSRAM(registers, mmap::sram + 3, 0x12);
     for(int i = 0; i < 16; ++i) // testing "echo" behavior
-      REQUIRE(cart.readSRAM(mmap::sram + 3 + (i * 512_B)) == 0x02);
+      REQUIRE(cart.readSRAM(registers, mmap::sram + 3 + (i * 512_B)) == 0x02);
 
-    cart.writeROM(0x0000, 0x00);                // ram disabled
-    cart.writeSRAM(mmap::sram, 0x0c);           // write should has no effect
-    REQUIRE(cart.readSRAM(mmap::sram) != 0x0c); // read should return a random value
+    cart.writeROM(registers, 0x0000, 0x00);                // ram disabled
+    cart.writeSRAM(registers, mmap::sram, 0x0c);           // write should has no effect
+    REQUIRE(cart.readSRAM(registers, mmap::sram) != 0x0c); // read should return a random value
   }
 }
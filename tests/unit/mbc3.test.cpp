@@ -1,5 +1,6 @@
 #include <LR35902/cartridge/kind/mbc3.h>
 #include <LR35902/cartridge/kind/mbc_config.h>
+#include <LR35902/cartridge/kind/mbc_registers.h>
 #include <LR35902/config.h>
 #include <LR35902/memory_map.h>
 
@@ -24,7 +25,8 @@ TEST_CASE("Memory bank controller cartridge type 3", "Read/Write ROM") {
   REQUIRE(ROM[127_ROMBANK] == 127);
 
   STATIC_CHECK(32_KiB == 4_SRAMBANK); // [0, 4)
-  mbc3 cart{ROM, {.sram_size = 4_SRAMBANK, .has_timer = true}};
+  mbc_registers registers;
+  mbc3 cart{rom_image::copy(ROM), {.sram_size = 4_SRAMBANK, .has_timer = true}, registers};
   enum {
     register_0 = 0, // SRAM enable
     register_1,     // ROM bank select
@@ -32,12 +34,12 @@ TEST_CASE("Memory bank controller cartridge type 3", "Read/Write ROM") {
     register_3      // clock related???
   } regs{};
 
-  const auto set_register = [&cart](const int reg, const byte val) {
+  const auto set_register = [&cart, &registers](const int reg, const byte val) {
     switch(reg) {
-    case register_0: cart.writeROM(0x0000, val); break;
-    case register_1: cart.writeROM(0x2000, val); break;
-    case register_2: cart.writeROM(0x4000, val); break;
-    case register_3: cart.writeROM(0x6000, val); break;
+    case register_0: cart.writeROM(registers, 0x0000, val); break;
+    case register_1: cart.writeROM(registers, 0x2000, val); break;
+    case register_2: cart.writeROM(registers, 0x4000, val); break;
+    case register_3: cart.writeROM(registers, 0x6000, val); break;
     }
   };
 
@@ -58,23 +60,23 @@ TEST_CASE("Memory bank controller cartridge type 3", "Read/Write ROM") {
   }
 
   SECTION("SRAM operations") {
-    cart.writeSRAM(mmap::sram, 0xab); // SRAM disabled by default, write should no effect and read should return a random
-    REQUIRE_FALSE(cart.readSRAM(mmap::sram) == 0xab);
+    cart.writeSRAM(registers, mmap::sram, 0xab); // SRAM disabled by default, write should no effect and read should return a random
+    REQUIRE_FALSE(cart.readSRAM(registers, mmap::sram) == 0xab);
 
     set_register(register_0, 0x0a); // should be enabled now
-    cart.writeSRAM(mmap::sram, 0xab);
-    REQUIRE(cart.readSRAM(mmap::sram) == 0xab);
+    cart.writeSRAM(registers, mmap::sram, 0xab);
+    REQUIRE(cart.readSRAM(registers, mmap::sram) == 0xab);
 
     set_register(register_2, 1);
-    cart.writeSRAM(mmap::sram, 0xbc);
-    REQUIRE(cart.readSRAM(mmap::sram) == 0xbc);
+    cart.writeSRAM(registers, mmap::sram, 0xbc);
+    REQUIRE(cart.readSRAM(registers, mmap::sram) == 0xbc);
 
     set_register(register_2, 2);
-    cart.writeSRAM(mmap::sram, 0xac);
-    REQUIRE(cart.readSRAM(mmap::sram) == 0xac);
+    cart.writeSRAM(registers, mmap::sram, 0xac);
+    REQUIRE(cart.readSRAM(registers, mmap::sram) == 0xac);
 
     set_register(register_2, 3);
-    cart.writeSRAM(mmap::sram, 0xcd);
-    REQUIRE(cart.readSRAM(mmap::sram) == 0xcd);
+    cart.writeSRAM(registers, mmap::sram, 0xcd);
+    REQUIRE(cart.readSRAM(registers, mmap::sram) == 0xcd);
   }
 }
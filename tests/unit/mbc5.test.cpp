@@ -1,5 +1,6 @@
 #include <LR35902/cartridge/kind/mbc5.h>
 #include <LR35902/cartridge/kind/mbc_config.h>
+#include <LR35902/cartridge/kind/mbc_registers.h>
 #include <LR35902/config.h>
 #include <LR35902/memory_map.h>
 
@@ -7,6 +8,7 @@
 
 #include <cstddef>
 #include <utility>
+#include <vector>
 
 using namespace LR35902;
 
@@ -36,31 +38,32 @@ TEST_CASE("Memory bank controller cartridge type 5", "Read/Write ROM") {
   REQUIRE(ROM[257_ROMBANK] == 254);
   REQUIRE(ROM[511_ROMBANK] == 0);
 
-  mbc5 cart{std::move(ROM), {.sram_size = 16_SRAMBANK}};
+  mbc_registers registers;
+  mbc5 cart{rom_image::copy(std::move(ROM)), {.sram_size = 16_SRAMBANK}, registers};
 
   STATIC_CHECK(16_SRAMBANK == 128_KiB); // [0, 16)
 
   enum { ramg = 0, romb_0, romb_1, ramb } regs{};
 
-  const auto set_register = [&cart](const int reg, const byte val) {
+  const auto set_register = [&cart, &registers](const int reg, const byte val) {
     switch(reg) {
-    case ramg: cart.writeROM(0x0000, val); break;
-    case romb_0: cart.writeROM(0x2000, val); break;
-    case romb_1: cart.writeROM(0x3000, val); break;
-    case ramb: cart.writeROM(0x4000, val);  break;
+    case ramg: cart.writeROM(registers, 0x0000, val); break;
+    case romb_0: cart.writeROM(registers, 0x2000, val); break;
+    case romb_1: cart.writeROM(registers, 0x3000, val); break;
+    case ramb: cart.writeROM(registers, 0x4000, val);  break;
     }
   };
 
   SECTION("ROM operations") {
     REQUIRE(cart.readROM(0) == 0);
 
-    cart.writeROM(0x2000, 1); // switch to bank 1
+    cart.writeROM(registers, 0x2000, 1); // switch to bank 1
     REQUIRE(cart.readROM(mmap::romx) == 1);
 
-    cart.writeROM(0x2000, 2);
+    cart.writeROM(registers, 0x2000, 2);
     REQUIRE(cart.readROM(mmap::romx) == 2);
 
-    cart.writeROM(0x2000, 255);
+    cart.writeROM(registers, 0x2000, 255);
     REQUIRE(cart.readROM(mmap::romx) == 255);
 
     set_register(romb_0, 0);
@@ -84,27 +87,27 @@ TEST_CASE("Memory bank controller cartridge type 5", "Read/Write ROM") {
    set_register(ramg, 0); // ram disabled, write has no effect and read returns random
    
    set_register(ramb, 0);  // ram bank 0 selected
-   cart.writeSRAM(mmap::sram, 33);
-   REQUIRE(cart.readSRAM(mmap::sram) != 33);
+   cart.writeSRAM(registers, mmap::sram, 33);
+   REQUIRE(cart.readSRAM(registers, mmap::sram) != 33);
 
    set_register(ramg, 0x0a); // ram enabled
    
-   cart.writeSRAM(mmap::sram, 33);
-   REQUIRE(cart.readSRAM(mmap::sram) == 33);
+   cart.writeSRAM(registers, mmap::sram, 33);
+   REQUIRE(cart.readSRAM(registers, mmap::sram) == 33);
 
-   cart.writeSRAM(mmap::sram, 44);
-   REQUIRE(cart.readSRAM(mmap::sram) == 44);
+   cart.writeSRAM(registers, mmap::sram, 44);
+   REQUIRE(cart.readSRAM(registers, mmap::sram) == 44);
 
 
    set_register(ramb, 1);
 
-   cart.writeSRAM(mmap::sram + 3, 33);
-   REQUIRE(cart.readSRAM(mmap::sram + 3) == 33);
+   cart.writeSRAM(registers, mmap::sram + 3, 33);
+   REQUIRE(cart.readSRAM(registers, mmap::sram + 3) == 33);
 
    set_register(ramb, 15);
 
-   cart.writeSRAM(mmap::sram + 4, 44);
-   REQUIRE(cart.readSRAM(mmap::sram + 4) != 55);
-   REQUIRE(cart.readSRAM(mmap::sram + 4) == 44);
+   cart.writeSRAM(registers, mmap::sram + 4, 44);
+   REQUIRE(cart.readSRAM(registers, mmap::sram + 4) != 55);
+   REQUIRE(cart.readSRAM(registers, mmap::sram + 4) == 44);
   }
 }
@@ -0,0 +1,37 @@
+#include <LR35902/config.h>
+#include <LR35902/interrupt/interrupt.h>
+#include <LR35902/io/io.h>
+#include <LR35902/ppu/ppu.h>
+#include <LR35902/state/state.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+
+using namespace LR35902;
+
+TEST_CASE("PPU catch-up", "Several modes passed in one update") {
+  State state;
+  IO &io = state.io;
+  io.LCDC = 0b1001'0001; // on, background only
+  io.STAT = 0b10;        // searching OAM, at the start of LY 0
+  io.LY = 0;
+  io.LYC = 0xff; // never coincides
+
+  Interrupt intr{state};
+  PPU ppu{intr, state};
+
+  SECTION("three scanlines at once") {
+    ppu.update(114 * 3); // machine cycles, 456 dots a scanline
+    REQUIRE(io.LY == 3);
+    REQUIRE((io.STAT & 0b11) == 0b10); // searching again, at the start of LY 3
+    REQUIRE(ppu.nextEvent() == 20);
+  }
+
+  SECTION("a whole frame at once") {
+    ppu.update(114 * 154 + 114 * 2 + 30);
+    REQUIRE(io.LY == 2);
+    REQUIRE((io.STAT & 0b11) == 0b11); // drawing, 10 cycles in
+    REQUIRE(ppu.nextEvent() == 43 - 10);
+  }
+}
@@ -0,0 +1,9 @@
+#include <tests/unit/machine.h>
+
+// Writes the synthetic ROM of machine.h to the file given, for gb.recomp to compile at build time.
+
+int main(int argc, const char *const argv[]) {
+  if(argc != 2) return 1;
+
+  LR35902::test::writeROM(argv[1]);
+}
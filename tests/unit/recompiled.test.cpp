@@ -0,0 +1,43 @@
+#include <LR35902/cpu/recompiled.h>
+#include <backend/Emu.h>
+#include <tests/unit/machine.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <string>
+
+// compiled by gb.recomp at build time, from the ROM recompiled.rom writes
+extern const LR35902::recompiled_rom recompiled_test_rom;
+
+using namespace LR35902;
+using namespace LR35902::test;
+
+namespace {
+
+constexpr int frames = 30;
+
+snapshot run(const std::string &rom, const recompiled_rom *const recompiled) {
+  const auto emu = std::make_unique<Emu>();
+  emu->plug(rom);
+  if(recompiled) REQUIRE(emu->attach(*recompiled));
+  emu->skipBoot();
+
+  for(int i = 0; i != frames; ++i)
+    emu->update();
+
+  return take(*emu);
+}
+
+}
+
+TEST_CASE("Recompiled", "The recompiled blocks run the ROM bit for bit as the interpreter does") {
+  const std::string rom = testROM("lr35902_recompiled.test.gb");
+  REQUIRE(!recompiled_test_rom.blocks.empty());
+
+  const snapshot interpreted = run(rom, nullptr);
+  const snapshot recompiled = run(rom, &recompiled_test_rom);
+
+  REQUIRE(interpreted.wram[0xd000 - mmap::wram0] != 0); // the timer interrupt was served
+  REQUIRE(recompiled == interpreted);
+}
@@ -0,0 +1,86 @@
+#include <LR35902/config.h>
+#include <backend/Emu.h>
+#include <backend/Rewind.h>
+#include <tests/unit/machine.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace LR35902;
+using namespace LR35902::test;
+
+TEST_CASE("Rewind", "Stepping back frame by frame") {
+  const std::string rom = testROM("lr35902_rewind.test.gb");
+
+  const auto emu = std::make_unique<Emu>();
+  emu->plug(rom);
+  emu->skipBoot();
+
+  constexpr int frames = 20;
+
+  SECTION("goes back through every recorded frame, in order") {
+    Rewind rewind{1_MiB};
+
+    std::vector<snapshot> history;
+    for(int i = 0; i != frames; ++i) {
+      emu->update();
+      rewind.push(*emu);
+      history.push_back(take(*emu));
+    }
+
+    REQUIRE(rewind.size() == frames - 1);
+
+    std::vector<byte> state;
+    emu->save(state);
+    REQUIRE(rewind.used() < state.size() * (frames - 1) / 4); // the deltas are mostly zeros
+
+    for(int i = frames - 2; i >= 0; --i) {
+      REQUIRE(rewind.back(*emu));
+      REQUIRE(take(*emu) == history[static_cast<std::size_t>(i)]);
+    }
+    REQUIRE_FALSE(rewind.back(*emu));
+  }
+
+  SECTION("running again from a frame gone back to records from there") {
+    Rewind rewind{1_MiB};
+
+    for(int i = 0; i != frames; ++i) {
+      emu->update();
+      rewind.push(*emu);
+    }
+
+    for(int i = 0; i != 5; ++i)
+      REQUIRE(rewind.back(*emu));
+    const snapshot from = take(*emu);
+
+    emu->update();
+    rewind.push(*emu);
+    REQUIRE(rewind.size() == frames - 1 - 5 + 1);
+
+    REQUIRE(rewind.back(*emu));
+    REQUIRE(take(*emu) == from);
+  }
+
+  SECTION("a small budget drops the oldest frames") {
+    Rewind rewind{4_KiB};
+
+    std::vector<snapshot> history;
+    for(int i = 0; i != frames; ++i) {
+      emu->update();
+      rewind.push(*emu);
+      history.push_back(take(*emu));
+    }
+
+    REQUIRE(rewind.used() <= 4_KiB);
+    REQUIRE(rewind.size() < frames - 1);
+
+    for(std::size_t i = history.size() - 1; rewind.size() != 0; --i) {
+      REQUIRE(rewind.back(*emu));
+      REQUIRE(take(*emu) == history[i - 1]);
+    }
+  }
+}
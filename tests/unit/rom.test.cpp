@@ -0,0 +1,52 @@
+#include <LR35902/cartridge/kind/rom.h>
+#include <LR35902/config.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace LR35902;
+
+TEST_CASE("ROM image", "Loaded from a file, shared without copying") {
+  std::vector<byte> bytes(1_MiB + 3, byte{});
+  for(std::size_t i = 0; i < bytes.size(); ++i)
+    bytes[i] = static_cast<byte>(i * 7);
+
+  const std::string path = (std::filesystem::temp_directory_path() / "lr35902_rom.test.gb").string();
+  {
+    std::ofstream fout{path, std::ios::binary};
+    fout.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+  }
+
+  SECTION("has the bytes of the file") {
+    const rom_t rom = rom_image::open(path.c_str());
+    REQUIRE(rom);
+    REQUIRE(rom->size() == bytes.size());
+    REQUIRE(std::vector<byte>(rom->bytes().begin(), rom->bytes().end()) == bytes);
+    REQUIRE((*rom)[bytes.size() - 1] == bytes.back());
+  }
+
+  SECTION("a copy of the pointer is the same image") {
+    const rom_t rom = rom_image::open(path.c_str());
+    const rom_t other = rom;
+    REQUIRE(other->data() == rom->data());
+  }
+
+  SECTION("nothing to load") {
+    REQUIRE_FALSE(rom_image::open("lr35902_there_is_no_such.gb"));
+
+    const std::string empty = (std::filesystem::temp_directory_path() / "lr35902_empty.test.gb").string();
+    std::ofstream{empty, std::ios::binary};
+    REQUIRE_FALSE(rom_image::open(empty.c_str()));
+  }
+
+  SECTION("from memory") {
+    const rom_t rom = rom_image::copy(bytes);
+    REQUIRE(rom->size() == bytes.size());
+    REQUIRE((*rom)[12345] == bytes[12345]);
+  }
+}
@@ -0,0 +1,61 @@
+#include <LR35902/config.h>
+#include <LR35902/cpu/registers/register_file.h>
+#include <backend/Emu.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+using namespace LR35902;
+
+namespace {
+
+// the code run from WRAM
+void load(Emu &emu, const std::span<const byte> code) {
+  for(std::size_t i = 0; i < code.size(); ++i)
+    emu.bus.write(static_cast<address_t>(0xc000 + i), code[i]);
+
+  register_file registers = emu.cpu.registers();
+  registers.PC.m_data = 0xc000;
+  emu.cpu.registers(registers);
+}
+
+}
+
+TEST_CASE("Run", "Stops at the first instruction boundary past the cycles") {
+  const auto emu = std::make_unique<Emu>();
+  emu->skipBoot();
+
+  // the longest instruction plus an interrupt dispatch
+  constexpr std::uint64_t overshoot = 6 + 5;
+
+  const auto check = [&] {
+    for(std::uint64_t cycles = 1; cycles < 3000; cycles += 37) {
+      const std::uint64_t ran = emu->run(cycles);
+      REQUIRE(ran >= cycles);
+      REQUIRE(ran < cycles + overshoot);
+    }
+  };
+
+  SECTION("polling LY, each read syncs the PPU") {
+    constexpr byte poll[]{
+        0xf0, 0x44, // ldh a,[LY]
+        0x18, 0xfc  // jr -4
+    };
+    load(*emu, poll);
+    check();
+  }
+
+  SECTION("writing TAC, each write reschedules the timer") {
+    constexpr byte write[]{
+        0x3e, 0x05, // ld a,0x05
+        0xe0, 0x07, // ldh [TAC],a
+        0x18, 0xfa  // jr -6
+    };
+    load(*emu, write);
+    check();
+  }
+}
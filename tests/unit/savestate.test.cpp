@@ -0,0 +1,85 @@
+#include <LR35902/config.h>
+#include <LR35902/savestate/savestate.h>
+#include <backend/Emu.h>
+#include <tests/unit/machine.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace LR35902;
+using namespace LR35902::test;
+
+namespace {
+
+std::unique_ptr<Emu> boot(const std::string &rom) {
+  auto emu = std::make_unique<Emu>();
+  emu->plug(rom);
+  emu->skipBoot();
+  return emu;
+}
+
+void run(Emu &emu, const int frames) {
+  for(int i = 0; i != frames; ++i)
+    emu.update();
+}
+
+}
+
+TEST_CASE("SaveState", "A restored machine goes on exactly as the one it was saved from") {
+  const std::string rom = testROM("lr35902_savestate.test.gb");
+
+  const auto emu = boot(rom);
+  run(*emu, 10);
+
+  std::vector<byte> state;
+  emu->save(state);
+  const snapshot saved = take(*emu);
+
+  run(*emu, 20);
+  const snapshot expected = take(*emu);
+
+  SECTION("into the same machine") {
+    REQUIRE(emu->load(state));
+    REQUIRE(take(*emu) == saved);
+
+    run(*emu, 20);
+    REQUIRE(take(*emu) == expected);
+  }
+
+  SECTION("into another machine") {
+    const auto other = boot(rom);
+    run(*other, 3);
+
+    REQUIRE(other->load(state));
+    REQUIRE(take(*other) == saved);
+
+    run(*other, 20);
+    REQUIRE(take(*other) == expected);
+  }
+
+  SECTION("saving again into the buffer gives the same bytes") {
+    REQUIRE(emu->load(state));
+
+    std::vector<byte> again;
+    emu->save(again);
+    REQUIRE(again == state);
+  }
+
+  SECTION("a broken state is refused and the machine left as it was") {
+    std::vector<byte> truncated{state.begin(), state.end() - 1};
+    REQUIRE_FALSE(emu->load(truncated));
+
+    std::vector<byte> other_version = state;
+    const std::uint32_t version = SaveState::version + 1;
+    std::memcpy(other_version.data() + sizeof(std::uint32_t), &version, sizeof(version));
+    REQUIRE_FALSE(emu->load(other_version));
+
+    REQUIRE_FALSE(emu->load({}));
+
+    REQUIRE(take(*emu) == expected);
+  }
+}
@@ -0,0 +1,61 @@
+#include <LR35902/config.h>
+#include <LR35902/cpu/clock/clock.h>
+#include <LR35902/interrupt/interrupt.h>
+#include <LR35902/io/io.h>
+#include <LR35902/ppu/ppu.h>
+#include <LR35902/scheduler/scheduler.h>
+#include <LR35902/state/state.h>
+#include <LR35902/timer/timer.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace LR35902;
+
+TEST_CASE("Scheduler", "Timer overflow") {
+  State state;
+  IO &io = state.io;
+  Interrupt intr{state};
+  PPU ppu{intr, state};
+  Timer timer{state, intr};
+  Clock clock{state};
+  Scheduler scheduler{state, clock, ppu, timer};
+
+  REQUIRE(clock.deadline() == Scheduler::max_slice); // the LCD and the timer are off
+
+  io.LCDC = 0;          // the PPU has nothing to do
+  io.TAC = 0b0000'0101; // on, TIMA counts the falling edges of bit 2: every 8 cycles
+  io.TIMA = 0xfe;
+  io.TMA = 0x42;
+  scheduler.sync();
+
+  SECTION("the deadline is where TIMA overflows") {
+    REQUIRE(clock.deadline() == 16);
+    REQUIRE_FALSE(clock.due());
+  }
+
+  SECTION("the timer catches up with all the cycles at once") {
+    clock.cycle(15);
+    scheduler.sync();
+    REQUIRE(io.TIMA == 0xff);
+    REQUIRE((io.IF & 0b0000'0100) == 0);
+
+    clock.cycle(1);
+    REQUIRE(clock.due());
+    scheduler.sync();
+    REQUIRE(io.TIMA == 0x42);
+    REQUIRE((io.IF & 0b0000'0100) != 0);
+    REQUIRE(clock.deadline() == 16 + (0x100 - 0x42) * 8);
+  }
+
+  SECTION("overflows more than once in a long stretch") {
+    clock.cycle(16 + (0x100 - 0x42) * 8 + 3 * 8);
+    scheduler.sync();
+    REQUIRE(io.TIMA == 0x42 + 3);
+  }
+
+  SECTION("nothing scheduled, the CPU still stops once a frame") {
+    io.TAC = 0;
+    scheduler.reschedule();
+    REQUIRE(clock.deadline() == Scheduler::max_slice);
+  }
+}
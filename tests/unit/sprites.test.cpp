@@ -0,0 +1,94 @@
+#include <LR35902/config.h>
+#include <LR35902/interrupt/interrupt.h>
+#include <LR35902/io/io.h>
+#include <LR35902/memory_map.h>
+#include <LR35902/ppu/ppu.h>
+#include <LR35902/state/state.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <random>
+
+using namespace LR35902;
+
+namespace {
+
+void frame(PPU &ppu) {
+  for(std::size_t cycles = 0; cycles < 154 * 114;) {
+    const std::size_t next = *ppu.nextEvent();
+    ppu.update(next);
+    cycles += next;
+  }
+}
+
+}
+
+TEST_CASE("Sprites on each line", "Kept up to date by the writes to OAM") {
+  State state;
+  std::minstd_rand engine{7};
+  for(auto &b : state.vram)
+    b = static_cast<byte>(engine());
+
+  Interrupt intr{state};
+  PPU ppu{intr, state};
+
+  // sprites moved around, many of them onto the same lines, by writes while the LCD is off and OAM is accessible
+  for(std::size_t i = 0; i < 4000; ++i) {
+    const std::size_t sprite = engine() % PPU::sprites;
+    const std::size_t field = engine() % PPU::sprite_size;
+    const byte b = field == 0 ? 16 + engine() % 48 : static_cast<byte>(engine());
+    ppu.writeOAM(mmap::oam + sprite * PPU::sprite_size + field, b);
+  }
+
+  state.io.OBP0 = 0xe4;
+  state.io.OBP1 = 0x1b;
+
+  // the same frame from a PPU that indexed OAM as it is from scratch
+  const auto compare = [&](const byte LCDC) {
+    state.io.LCDC = LCDC;
+
+    State copy = state;
+    Interrupt copy_intr{copy};
+    PPU fresh{copy_intr, copy};
+
+    frame(ppu);
+    frame(fresh);
+    REQUIRE(ppu.getFrameBuffer() == fresh.getFrameBuffer());
+  };
+
+  SECTION("8x8") {
+    compare(0b1000'0010); // on, sprites on
+  }
+
+  SECTION("8x16") {
+    compare(0b1000'0110);
+  }
+}
+
+TEST_CASE("Sprites off the sides", "Take one of the 10 places of their line") {
+  State state;
+  for(std::size_t i = 0; i < PPU::tile_size; ++i)
+    state.vram[i] = 0xff; // tile 0, every pixel of color 3
+
+  Interrupt intr{state};
+  PPU ppu{intr, state};
+
+  // 11 sprites on lines 0 to 7, the first in OAM at x 0, hidden left of the screen
+  const auto place = [&](const std::size_t sprite, const byte x) {
+    ppu.writeOAM(mmap::oam + sprite * PPU::sprite_size + 0, 16);
+    ppu.writeOAM(mmap::oam + sprite * PPU::sprite_size + 1, x);
+  };
+  place(0, 0);
+  for(std::size_t sprite = 1; sprite <= 10; ++sprite)
+    place(sprite, static_cast<byte>(8 + 12 * sprite)); // at 12 * sprite on the screen
+
+  state.io.OBP0 = 0xe4;
+  state.io.LCDC = 0b1000'0010; // on, sprites on
+  frame(ppu);
+
+  const PPU::framebuffer_t &framebuffer = ppu.getFrameBuffer();
+  for(std::size_t sprite = 1; sprite <= 9; ++sprite)
+    REQUIRE(framebuffer[12 * sprite] == 3);
+  REQUIRE(framebuffer[12 * 10] == 0); // the 11th of the line
+}
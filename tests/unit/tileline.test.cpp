@@ -0,0 +1,34 @@
+#include <LR35902/config.h>
+#include <LR35902/ppu/tileline.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+
+using namespace LR35902;
+
+TEST_CASE("Tile line decoding", "The table against the bits") {
+  SECTION("the example in ppu.h") {
+    STATIC_CHECK(decodeTilelineBits(0xff, 0x00) == tileline_t{1, 1, 1, 1, 1, 1, 1, 1});
+    STATIC_CHECK(decodeTilelineBits(0x7e, 0xff) == tileline_t{2, 3, 3, 3, 3, 3, 3, 2});
+    STATIC_CHECK(decodeTilelineBits(0x85, 0x81) == tileline_t{3, 0, 0, 0, 0, 1, 0, 3});
+    STATIC_CHECK(decodeTilelineBits(0xc9, 0x97) == tileline_t{3, 1, 0, 2, 1, 2, 2, 3});
+
+    REQUIRE(decodeTileline(0x89, 0x83) == tileline_t{3, 0, 0, 0, 1, 0, 2, 3});
+    REQUIRE(decodeTileline(0xa5, 0x8b) == tileline_t{3, 0, 1, 0, 2, 1, 2, 3});
+  }
+
+  SECTION("every one of the 65536 lines") {
+    std::size_t mismatches = 0;
+    for(std::size_t upper = 0; upper < 0x100; ++upper) {
+      for(std::size_t lower = 0; lower < 0x100; ++lower) {
+        const tileline_t line = decodeTileline(lower, upper);
+        for(std::size_t px = 0; px < line.size(); ++px) {
+          const std::size_t bit = 7 - px; // the leftmost pixel in bit 7
+          if(line[px] != (((upper >> bit) & 1) << 1 | ((lower >> bit) & 1))) ++mismatches;
+        }
+      }
+    }
+    REQUIRE(mismatches == 0);
+  }
+}
@@ -0,0 +1,81 @@
+#include <LR35902/config.h>
+#include <LR35902/interrupt/interrupt.h>
+#include <LR35902/io/io.h>
+#include <LR35902/memory_map.h>
+#include <LR35902/ppu/ppu.h>
+#include <LR35902/state/state.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <random>
+
+using namespace LR35902;
+
+namespace {
+
+void frame(PPU &ppu) {
+  for(std::size_t cycles = 0; cycles < 154 * 114;) {
+    const std::size_t next = *ppu.nextEvent();
+    ppu.update(next);
+    cycles += next;
+  }
+}
+
+}
+
+TEST_CASE("Decoded tiles", "Decoded again once written to") {
+  State state;
+  std::minstd_rand engine{11};
+  for(auto &b : state.vram)
+    b = static_cast<byte>(engine());
+  for(auto &b : state.oam)
+    b = static_cast<byte>(16 + engine() % 144);
+
+  state.io.LCDC = 0b1010'0111; // on, window at 0x9800, background at 0x8800, sprites 8x16, all on
+  state.io.BGP = 0xe4;
+  state.io.OBP0 = 0xd2;
+  state.io.OBP1 = 0x1b;
+  state.io.SCX = 5;
+  state.io.WY = 60;
+  state.io.WX = 40;
+
+  Interrupt intr{state};
+  PPU ppu{intr, state};
+  frame(ppu); // every tile in use decoded
+
+  SECTION("a frame after the tile set changed") {
+    // some bytes rewritten, some written the same as they were
+    for(std::size_t i = 0; i < 2000; ++i) {
+      const std::size_t index = engine() % PPU::tileset_size;
+      const byte b = engine() % 2 ? state.vram[index] : static_cast<byte>(engine());
+      ppu.writeVRAM(mmap::vram + index, b);
+    }
+
+    // what a PPU that never decoded any of them shows
+    State copy = state;
+    Interrupt copy_intr{copy};
+    PPU fresh{copy_intr, copy};
+
+    frame(ppu);
+    frame(fresh);
+    REQUIRE(ppu.getFrameBuffer() == fresh.getFrameBuffer());
+  }
+
+  SECTION("a frame after taking another PPU over") {
+    // one that decoded other tiles
+    State other = state;
+    for(auto &b : other.vram)
+      b = static_cast<byte>(engine());
+    Interrupt other_intr{other};
+    PPU taking{other_intr, other};
+    frame(taking);
+
+    other = state; // VRAM comes along with the State
+    taking = ppu;
+
+    frame(ppu);
+    frame(taking);
+    REQUIRE(taking.getFrameBuffer() == ppu.getFrameBuffer());
+  }
+}
@@ -0,0 +1,205 @@
+#include <LR35902/bus/bus.h>
+#include <LR35902/config.h>
+#include <LR35902/cpu/block_cache.h>
+#include <LR35902/cpu/recompiled.h>
+#include <LR35902/memory_map.h>
+
+#include <CLI/CLI.hpp>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+// Walks the code reachable from the entry point, the rst and the interrupt vectors, bank by bank, and emits a C++
+// function for each basic block it finds. Compiled and linked next to the core, the blocks run natively once attached
+// with Emu::attach, everything else (code in RAM, computed jumps gb.recomp couldn't follow) is interpreted.
+//
+// The blocks are cut exactly where the interpreter's block cache cuts them: after a control flow instruction, at the
+// end of a 256 byte page and after BlockCache::max_block_length instructions.
+
+using namespace LR35902;
+
+namespace {
+
+struct block_t {
+  std::size_t rom_offset;
+  std::vector<micro_op> ops;
+};
+
+class Walker {
+  std::span<const byte> m_rom;
+  std::size_t m_banks;
+
+  std::vector<bool> m_visited;
+  std::vector<std::size_t> m_pending;
+  std::map<std::size_t, block_t> m_blocks; // sorted by the offset, as recompiled_rom expects
+
+  // the offsets in the ROM file the address may refer to, the bank unknown when code in bank 0 jumps into ROMX
+  void follow(const std::size_t bank, const std::size_t address) {
+    if(address < mmap::rom0_end) m_pending.push_back(address);
+    else if(address < mmap::romx_end) {
+      const std::size_t offset = address - mmap::romx;
+      if(bank != 0) m_pending.push_back(bank * rom_bank_size + offset);
+      else
+        for(std::size_t b = 1; b < m_banks; ++b)
+          m_pending.push_back(b * rom_bank_size + offset);
+    }
+    // the rest is RAM, left to the interpreter
+  }
+
+  void visit(const std::size_t rom_offset) {
+    if(rom_offset >= m_rom.size() || m_visited[rom_offset]) return;
+    m_visited[rom_offset] = true;
+
+    const std::size_t bank = rom_offset / rom_bank_size;
+    const std::size_t address = bank == 0 ? rom_offset : mmap::romx + rom_offset % rom_bank_size;
+    const std::size_t available = Bus::page_size - address % Bus::page_size;
+
+    std::array<micro_op, BlockCache::max_block_length> ops;
+    const std::size_t length = decode(m_rom.data() + rom_offset, available, ops);
+
+    if(length == 0) { // the instruction crosses the page, the interpreter decodes it through the bus
+      follow(bank, address + instruction_length(m_rom[rom_offset]));
+      return;
+    }
+
+    m_blocks.emplace(rom_offset, block_t{rom_offset, {ops.begin(), ops.begin() + length}});
+
+    std::size_t next = address;
+    for(std::size_t i = 0; i < length; ++i)
+      next += instruction_length(ops[i].opcode);
+
+    const micro_op &last = ops[length - 1];
+    const auto target = [&] { return static_cast<std::size_t>(last.operand[1] << 8 | last.operand[0]); };
+    const auto relative = [&] {
+      return static_cast<std::size_t>(static_cast<word>(next + static_cast<sbyte>(last.operand[0])));
+    };
+
+    // clang-format off
+    switch(last.opcode) {
+    case 0xc3: follow(bank, target()); break;   // jp n16
+    case 0x18: follow(bank, relative()); break; // jr e8
+    case 0xc9: case 0xd9: case 0xe9: break;     // ret, reti, jp HL
+
+    case 0xc2: case 0xca: case 0xd2: case 0xda: // jp cc,n16
+    case 0xc4: case 0xcc: case 0xcd: case 0xd4: case 0xdc: // call
+      follow(bank, target());
+      follow(bank, next);
+      break;
+
+    case 0x20: case 0x28: case 0x30: case 0x38: // jr cc,e8
+      follow(bank, relative());
+      follow(bank, next);
+      break;
+
+    case 0xc7: case 0xcf: case 0xd7: case 0xdf: case 0xe7: case 0xef: case 0xf7: case 0xff: // rst
+      follow(bank, last.opcode & 0b0011'1000);
+      follow(bank, next);
+      break;
+
+    default: follow(bank, next); // ret cc, halt, stop, or the block was cut
+    }
+    // clang-format on
+  }
+
+public:
+  explicit Walker(const std::span<const byte> rom) :
+      m_rom{rom},
+      m_banks{std::max<std::size_t>(rom.size() / rom_bank_size, 1)},
+      m_visited(rom.size()) {}
+
+  const std::map<std::size_t, block_t> &walk() {
+    follow(0, mmap::entry_begin);
+    for(std::size_t v = 0; v <= 0x38; v += 8)
+      follow(0, v);
+    for(const address_t v : {mmap::vblank, mmap::lcd_stat, mmap::timer, mmap::serial, mmap::joypad})
+      follow(0, v);
+
+    while(!m_pending.empty()) {
+      const std::size_t offset = m_pending.back();
+      m_pending.pop_back();
+      visit(offset);
+    }
+
+    return m_blocks;
+  }
+};
+
+std::string emit(const std::string &romFile, const std::string &symbol, std::span<const byte> rom,
+                 const std::map<std::size_t, block_t> &blocks) {
+  std::string out = fmt::format("// generated by gb.recomp from {}, do not edit\n", romFile);
+  out += "#include <LR35902/cpu/cpu.h>\n"
+         "#include <LR35902/cpu/execute.h>\n"
+         "#include <LR35902/cpu/recompiled.h>\n\n"
+         "#include <cstdint>\n\n"
+         "using namespace LR35902;\n\n"
+         "namespace {\n\n";
+
+  for(const auto &[offset, block] : blocks) {
+    const std::size_t bank = offset / rom_bank_size;
+    const std::size_t address = bank == 0 ? offset : mmap::romx + offset % rom_bank_size;
+
+    out += fmt::format("// bank {:02x}, {:04x}\n", bank, address);
+    out += fmt::format("std::uint32_t block_{:06x}(CPU &cpu) noexcept {{\n", offset);
+    out += "  static constexpr micro_op ops[]{";
+    for(const micro_op &op : block.ops)
+      out += fmt::format("{{0x{:02x}, {{0x{:02x}, 0x{:02x}}}}}, ", op.opcode, op.operand[0], op.operand[1]);
+    out += "};\n\n";
+
+    for(std::size_t i = 0; i + 1 < block.ops.size(); ++i)
+      out += fmt::format("  if(CPU::step<0x{:02x}>(cpu, ops[{}])) return {};\n", block.ops[i].opcode, i, i + 1);
+    out += fmt::format("  CPU::step<0x{:02x}>(cpu, ops[{}]);\n", block.ops.back().opcode, block.ops.size() - 1);
+    out += fmt::format("  return {};\n}}\n\n", block.ops.size());
+  }
+
+  out += "constexpr recompiled_block blocks[]{\n";
+  for(const auto &[offset, block] : blocks)
+    out += fmt::format("  {{0x{:06x}, {}, &block_{:06x}}},\n", offset, block.ops.size(), offset);
+  out += "};\n\n}\n\n";
+
+  out += fmt::format("extern const recompiled_rom {}{{{}, 0x{:04x}, blocks}};\n", symbol, rom.size(),
+                     recompiled_checksum(rom));
+  return out;
+}
+
+}
+
+int main(int argc, const char *const argv[]) {
+  CLI::App app{"Compiles the code of a ROM into C++, one function per basic block"};
+
+  std::string romFile;
+  std::string outFile;
+  std::string symbol = "recompiled";
+
+  app.add_option("rom.file.gb", romFile)->check(CLI::ExistingFile)->required(true);
+  app.add_option("-o,--output", outFile, "C++ source to write")->required(true);
+  app.add_option("--symbol", symbol, "Name of the LR35902::recompiled_rom to define")->capture_default_str();
+
+  try {
+    app.parse(argc, argv);
+  }
+  catch(const CLI::ParseError &e) {
+    return app.exit(e);
+  }
+
+  std::ifstream fin{romFile, std::ios_base::in | std::ios_base::binary};
+  const std::vector<byte> rom(std::istreambuf_iterator<char>{fin}, {});
+  fin.close();
+
+  Walker walker{rom};
+  const std::map<std::size_t, block_t> &blocks = walker.walk();
+
+  std::ofstream fout{outFile};
+  fout << emit(romFile, symbol, rom, blocks);
+
+  fmt::print("{}: {} blocks\n", outFile, blocks.size());
+  return fout ? 0 : 1;
+}
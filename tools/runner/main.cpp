@@ -0,0 +1,153 @@
+#include <LR35902/joypad/joypad.h>
+#include <LR35902/scheduler/scheduler.h>
+#include <backend/Emu.h>
+
+#include <CLI/CLI.hpp>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Runs a ROM with no window, no audio and no frame pacing, as fast as the host allows, for a number of frames or of
+// machine cycles, then prints how fast it went. The joypad is driven by an optional input script, one event per line:
+//
+//   # frame  button  press|release
+//   120      start   press
+//   122      start   release
+//
+// An event applies at the start of the frame, frames count from 0. With a cycle budget a frame is 17556 cycles.
+
+namespace lr = LR35902;
+
+namespace {
+
+constexpr std::uint64_t frame_cycles = lr::Scheduler::max_slice;
+constexpr double cycles_per_second = 1'048'576.0; // machine cycles, the crystal runs 4 times faster
+
+struct event {
+  std::uint64_t frame;
+  lr::button btn;
+  lr::keystatus status;
+};
+
+const std::map<std::string, lr::button> buttons{
+    {"up", lr::button::up},
+    {"right", lr::button::right},
+    {"down", lr::button::down},
+    {"left", lr::button::left},
+    {"a", lr::button::a},
+    {"b", lr::button::b},
+    {"select", lr::button::select},
+    {"start", lr::button::start},
+};
+
+const std::map<std::string, lr::keystatus> statuses{
+    {"press", lr::keystatus::pressed},
+    {"release", lr::keystatus::released},
+};
+
+// the events sorted by frame, nullopt with the offending line reported if the script doesn't parse
+std::optional<std::vector<event>> readScript(const std::string &file) {
+  std::ifstream fin{file};
+  std::vector<event> events;
+
+  std::string line;
+  for(std::size_t number = 1; std::getline(fin, line); ++number) {
+    line = line.substr(0, line.find('#'));
+
+    std::istringstream in{line};
+    std::uint64_t frame;
+    std::string btn;
+    std::string status;
+    if(!(in >> frame)) {
+      if(in.eof()) continue; // blank or comment only
+    } else if(in >> btn >> status && buttons.contains(btn) && statuses.contains(status)) {
+      events.push_back({frame, buttons.at(btn), statuses.at(status)});
+      continue;
+    }
+
+    fmt::print(stderr, "{}:{}: expected \"<frame> <button> press|release\"\n", file, number);
+    return std::nullopt;
+  }
+
+  std::ranges::stable_sort(events, {}, &event::frame);
+  return events;
+}
+
+}
+
+int main(int argc, const char *const argv[]) {
+  CLI::App app{"Runs a ROM headless as fast as possible and reports the throughput"};
+
+  std::string romFile;
+  std::uint64_t frames = 0;
+  std::uint64_t cycles = 0;
+  std::string scriptFile;
+  bool noIdleSkip = false;
+
+  app.add_option("rom.file.gb", romFile)->check(CLI::ExistingFile)->required(true);
+  auto *const framesOption = app.add_option("-f,--frames", frames, "Frames to run");
+  app.add_option("-c,--cycles", cycles, "Machine cycles to run")->excludes(framesOption);
+  app.add_option("-i,--input", scriptFile, "Input script")->check(CLI::ExistingFile);
+  app.add_flag("--no-idle-skip", noIdleSkip, "Execute every iteration of idle polling loops");
+
+  try {
+    app.parse(argc, argv);
+  }
+  catch(const CLI::ParseError &e) {
+    return app.exit(e);
+  }
+
+  if(frames == 0 && cycles == 0) frames = 60;
+
+  std::vector<event> events;
+  if(!scriptFile.empty()) {
+    const std::optional<std::vector<event>> script = readScript(scriptFile);
+    if(!script) return 1;
+    events = *script;
+  }
+
+  const auto emu = std::make_unique<Emu>(); // too big for the stack
+  if(!emu->plug(romFile)) {
+    fmt::print(stderr, "{}: not a ROM\n", romFile);
+    return 1;
+  }
+  emu->skipBoot();
+  emu->cpu.skipIdleLoops(!noIdleSkip);
+
+  const std::uint64_t steps = frames != 0 ? frames : (cycles + frame_cycles - 1) / frame_cycles;
+  auto next = events.cbegin();
+
+  const auto begin = std::chrono::steady_clock::now();
+
+  for(std::uint64_t frame = 0; frame != steps; ++frame) {
+    for(; next != events.cend() && next->frame <= frame; ++next)
+      emu->joypad.update(next->btn, next->status);
+
+    if(frames != 0) emu->update();
+    else emu->run(std::min(frame_cycles, cycles - frame * frame_cycles));
+  }
+
+  const auto end = std::chrono::steady_clock::now();
+
+  const double seconds = std::chrono::duration<double>(end - begin).count();
+  const std::uint64_t ran = emu->clock.data();
+  const std::uint64_t instructions = emu->cpu.retired();
+  const double guest_seconds = static_cast<double>(ran) / cycles_per_second;
+
+  fmt::print("{} frames, {} cycles, {} instructions in {:.3f} s\n", steps, ran, instructions, seconds);
+  fmt::print("{:.1f} frames/s\n", static_cast<double>(ran) / frame_cycles / seconds);
+  fmt::print("{:.2f} guest MHz ({:.1f}x real time)\n", 4 * static_cast<double>(ran) / seconds / 1e6,
+             guest_seconds / seconds);
+  fmt::print("{:.2f} host ns/instruction\n", seconds * 1e9 / static_cast<double>(std::max<std::uint64_t>(instructions, 1)));
+  if(const std::uint64_t skipped = emu->cpu.skippedCycles()) fmt::print("{} cycles skipped in idle loops\n", skipped);
+}
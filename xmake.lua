@@ -11,14 +11,21 @@ add_requires("imgui", {configs = {opengl3 = true}})
 add_rules("mode.debug", "mode.release")
 add_rules("plugin.compile_commands.autoupdate", {outputdir = ".vscode"})
 
+option("threaded_dispatch", {default = true, showmenu = true})
+option_end()
+
+option("lazy_flags", {default = false, showmenu = true})
+option_end()
+
 target("core")
   set_kind("static")
   add_files("src/cpu/cpu.cpp",
-          "src/cpu/registers/r16.cpp",
+          "src/cpu/block_cache.cpp",
           "src/cpu/registers/r8.cpp",
           "src/bus/bus.cpp",
           "src/cartridge/cartridge.cpp",
           "src/cartridge/header/header.cpp",
+          "src/cartridge/kind/rom.cpp",
           "src/cartridge/kind/rom_only.cpp",
           "src/cartridge/kind/rom_ram.cpp",
           "src/cartridge/kind/mbc1.cpp",
@@ -26,11 +33,14 @@ target("core")
           "src/cartridge/kind/mbc3.cpp",
           "src/cartridge/kind/mbc5.cpp",
           "src/ppu/ppu.cpp",
+          "src/ppu/tileline.cpp",
           "src/builtin/builtin.cpp",
           "src/io/io.cpp",
           "src/joypad/joypad.cpp",
           "src/dma/dma.cpp",
           "src/timer/timer.cpp",
+          "src/scheduler/scheduler.cpp",
+          "src/savestate/savestate.cpp",
           "src/interrupt/interrupt.cpp")
   add_includedirs("include")
   add_cxxflags("cl::/Zc:__cplusplus")
@@ -39,11 +49,19 @@ target("core")
   if has_config("with_debugger") then
       add_defines("WITH_DEBUGGER")
   end
+
+  if has_config("threaded_dispatch") then
+      add_defines("THREADED_DISPATCH")
+  end
+
+  if has_config("lazy_flags") then
+      add_defines("LAZY_FLAGS", {public = true})
+  end
 target_end()
 
 target("attaboy")
    set_kind("static")
-   add_files("backend/Emu.cpp")
+   add_files("backend/Emu.cpp", "backend/BatchRunner.cpp", "backend/Rewind.cpp")
    add_deps("core")
    add_includedirs(".", "include")
    if has_config("with_debugger") then
@@ -95,4 +113,20 @@ option("with_tools", {default = false, showmenu = true})
       add_deps("core")
       add_packages("range-v3", "fmt", "cli11")
     target_end()
+
+    target("gb.recomp")
+      set_kind("binary")
+      add_files("tools/recompiler/main.cpp")
+      add_includedirs("include")
+      add_deps("core")
+      add_packages("fmt", "cli11")
+    target_end()
+
+    target("gb.run")
+      set_kind("binary")
+      add_files("tools/runner/main.cpp")
+      add_includedirs(".", "include")
+      add_deps("attaboy", "core")
+      add_packages("fmt", "cli11")
+    target_end()
 option_end()